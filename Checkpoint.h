@@ -0,0 +1,166 @@
+#ifndef FPU_CHECKPOINT_H
+#define FPU_CHECKPOINT_H
+
+// Versioned binary snapshots of the pipelined core's state.
+// Each stage lists its state once in a checkpoint_state(Ar&) member. Ar is
+// either checkpoint_writer (save) or checkpoint_reader (restore), so save
+// and load can never drift apart.
+//
+// Layout: checkpoint_header_t, then one section per stage:
+//   char tag[4], uint32 payload bytes, payload (fields as little-endian u64)
+
+#include <systemc.h>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static const char     CHECKPOINT_MAGIC[8] = {'F', 'P', 'U', 'C', 'K', 'P', 'T', 0};
+static const uint32_t CHECKPOINT_VERSION  = 4;
+
+struct checkpoint_header_t {
+    char     magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t sim_time_ps;   // simulation time the snapshot was taken at, informational
+};
+
+class checkpoint_writer {
+public:
+    explicit checkpoint_writer(std::vector<uint8_t>& out, uint64_t sim_time_ps) : buf(out), section_at(0) {
+        buf.clear();
+        checkpoint_header_t h;
+        std::memcpy(h.magic, CHECKPOINT_MAGIC, sizeof(h.magic));
+        h.version     = CHECKPOINT_VERSION;
+        h.reserved    = 0;
+        h.sim_time_ps = sim_time_ps;
+        append(&h, sizeof(h));
+    }
+
+    void begin_section(const char* tag) {
+        append(tag, 4);
+        uint32_t len = 0;
+        section_at = buf.size();
+        append(&len, sizeof(len));
+    }
+    void end_section() {
+        uint32_t len = (uint32_t)(buf.size() - section_at - sizeof(uint32_t));
+        std::memcpy(&buf[section_at], &len, sizeof(len));
+    }
+
+    void io(bool& v) { put(v); }
+    void io(uint64_t& v) { put(v); }
+    template <int W> void io(sc_uint<W>& v) { put(v.to_uint64()); }
+    template <int W> void io(sc_int<W>& v) { put((uint64_t)v.to_int64()); }
+    template <class T> void io(sc_signal<T>& s) { T v = s.read(); io(v); }
+    // Structs provide a checkpoint_io(Ar&, T&) listing their fields
+    template <class T> void io(T& v) { checkpoint_io(*this, v); }
+
+    // Configuration that must match on restore (e.g. divider slot count)
+    void expect(uint64_t v, const char*) { put(v); }
+
+    bool ok() const { return true; }
+
+private:
+    void put(uint64_t v) { append(&v, sizeof(v)); }
+    void append(const void* p, size_t n) {
+        const uint8_t* b = static_cast<const uint8_t*>(p);
+        buf.insert(buf.end(), b, b + n);
+    }
+
+    std::vector<uint8_t>& buf;
+    size_t                section_at;
+};
+
+class checkpoint_reader {
+public:
+    // With apply = false the snapshot is only validated, nothing is written
+    checkpoint_reader(const std::vector<uint8_t>& in, bool apply)
+        : buf(in), apply(apply), pos(0), section_end(0), good(true), header() {
+        checkpoint_header_t h;
+        if (!take(&h, sizeof(h)) || std::memcmp(h.magic, CHECKPOINT_MAGIC, sizeof(h.magic)) != 0) {
+            fail("not an FPU checkpoint");
+        } else if (h.version != CHECKPOINT_VERSION) {
+            fail("checkpoint version " + std::to_string(h.version) + ", expected " +
+                 std::to_string(CHECKPOINT_VERSION));
+        } else {
+            header = h;
+        }
+    }
+
+    void begin_section(const char* tag) {
+        char     t[4];
+        uint32_t len;
+        if (!good) return;
+        if (!take(t, 4) || !take(&len, sizeof(len))) return fail("truncated checkpoint");
+        if (std::memcmp(t, tag, 4) != 0) return fail(std::string("expected section ") + std::string(tag, 4));
+        section_end = pos + len;
+        if (section_end > buf.size()) fail("truncated section " + std::string(tag, 4));
+    }
+    void end_section() {
+        if (good && pos != section_end) fail("section size mismatch");
+    }
+
+    void io(bool& v) { uint64_t x = get(); if (apply) v = x != 0; }
+    void io(uint64_t& v) { uint64_t x = get(); if (apply) v = x; }
+    template <int W> void io(sc_uint<W>& v) { uint64_t x = get(); if (apply) v = x; }
+    template <int W> void io(sc_int<W>& v) { uint64_t x = get(); if (apply) v = (int64_t)x; }
+    template <class T> void io(sc_signal<T>& s) { T v = T(); io(v); if (apply) s.write(v); }
+    template <class T> void io(T& v) { checkpoint_io(*this, v); }
+
+    void expect(uint64_t v, const char* what) {
+        uint64_t got = get();
+        if (good && got != v)
+            fail(std::string(what) + " is " + std::to_string(got) + " in the checkpoint, " + std::to_string(v) +
+                 " in this build");
+    }
+
+    bool ok() const { return good; }
+    const std::string& error() const { return message; }
+    const checkpoint_header_t& info() const { return header; }
+
+private:
+    uint64_t get() {
+        uint64_t v = 0;
+        if (good && !take(&v, sizeof(v))) fail("truncated checkpoint");
+        return v;
+    }
+    bool take(void* p, size_t n) {
+        if (pos + n > buf.size()) return false;
+        std::memcpy(p, &buf[pos], n);
+        pos += n;
+        return true;
+    }
+    void fail(const std::string& why) {
+        if (good) message = why;
+        good = false;
+    }
+
+    const std::vector<uint8_t>& buf;
+    bool                        apply;
+    size_t                      pos;
+    size_t                      section_end;
+    bool                        good;
+    std::string                 message;
+    checkpoint_header_t         header;
+};
+
+static inline bool checkpoint_write_file(const std::string& path, const std::vector<uint8_t>& data) {
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(data.data(), 1, data.size(), f) == data.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+static inline bool checkpoint_read_file(const std::string& path, std::vector<uint8_t>& data) {
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+    data.clear();
+    uint8_t chunk[65536];
+    size_t  n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), f)) != 0) data.insert(data.end(), chunk, chunk + n);
+    std::fclose(f);
+    return true;
+}
+
+#endif // FPU_CHECKPOINT_H
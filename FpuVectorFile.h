@@ -0,0 +1,265 @@
+#ifndef FPU_VECTOR_FILE_H
+#define FPU_VECTOR_FILE_H
+
+// Binary test-vector files for batch runs of the pipelined Execute stage
+// (VectorDriver.h, src/Benchmark/vectors_pipelined.cpp) and the golden
+// vector database the SystemC and SystemVerilog testbenches stream from
+// (Testbench.cpp --vectors, src/Testbench/fpu_vector_db.svh). Both files are
+// mapped rather than read, so a run over millions of vectors does no text
+// parsing and no per-record I/O.
+//
+// Vector file: fpu_vector_header_t ("FPUVEC"), then count fpu_vector_t,
+// then the class index: FPU_VECTOR_BUCKETS + 1 uint32_t bucket starts and
+// count uint32_t vector numbers, grouped by bucket and in file order within
+// one. Bucket k holds vector numbers [start[k], start[k + 1]), so all FDIVs
+// of a NaN by a normal number are one slice away.
+// Result file: fpu_vector_header_t ("FPURES"), then count
+// fpu_vector_result_t, record i belonging to vector i. Created zero-filled,
+// so a record still at FPU_VECTOR_NOT_RUN was never completed.
+// Little-endian host order.
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+static const char     FPU_VECTOR_MAGIC[8] = {'F', 'P', 'U', 'V', 'E', 'C', 0, 0};
+static const char     FPU_RESULT_MAGIC[8] = {'F', 'P', 'U', 'R', 'E', 'S', 0, 0};
+static const uint32_t FPU_VECTOR_VERSION  = 2;   // 2 added the class tags and index
+static const uint32_t FPU_RESULT_VERSION  = 2;   // 2 dropped the attempts count
+
+struct fpu_vector_header_t {
+    char     magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t count;
+};
+
+enum fpu_vector_flags {
+    FPU_VECTOR_CHECK = 0x1      // expected and expected_exceptions are valid
+};
+
+struct fpu_vector_t {
+    uint8_t  opcode;                // fp_instruction_t opcode: 0 fadd, 1 fsub, 2 fmul, 3 fdiv
+    uint8_t  flags;                 // fpu_vector_flags
+    uint8_t  expected_exceptions;   // fp_exceptions bits
+    uint8_t  classes;               // operand classes (fp_operand_class): a in bits 3:0, b in 7:4
+    uint32_t a;
+    uint32_t b;
+    uint32_t expected;
+};
+
+// Index buckets: opcode x class of a x class of b, three bits per class.
+// The classes are fp_stream_gen.h's fp_operand_class, in the same order.
+static const unsigned FPU_VECTOR_CLASSES = 8;
+
+static const char* const fpu_vector_op_names[4] = {"fadd", "fsub", "fmul", "fdiv"};
+static const char* const fpu_vector_class_names[7] = {"zero", "denormal", "tiny", "normal", "huge", "inf", "nan"};
+static const unsigned FPU_VECTOR_BUCKETS = 4 * FPU_VECTOR_CLASSES * FPU_VECTOR_CLASSES;
+
+static inline uint8_t fpu_vector_classes(unsigned class_a, unsigned class_b) {
+    return (uint8_t)((class_a & 0xF) | (class_b & 0xF) << 4);
+}
+static inline unsigned fpu_vector_bucket(unsigned opcode, unsigned class_a, unsigned class_b) {
+    return ((opcode & 3) * FPU_VECTOR_CLASSES + (class_a & 7)) * FPU_VECTOR_CLASSES + (class_b & 7);
+}
+static inline unsigned fpu_vector_bucket(const fpu_vector_t& v) {
+    return fpu_vector_bucket(v.opcode, v.classes & 0xF, v.classes >> 4);
+}
+
+// "OP:A:B" (e.g. "fdiv:nan:normal") to fpu_vector_map::select() arguments.
+// Any part may be "*" or left off, which matches anything.
+static inline bool fpu_vector_parse_select(const std::string& spec, int& opcode, int& class_a, int& class_b) {
+    int* field[3] = {&opcode, &class_a, &class_b};
+    size_t pos = 0;
+    for (int f = 0; f < 3; ++f) {
+        size_t end = spec.find(':', pos);
+        std::string part = pos > spec.size() ? "" : spec.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+        pos = end == std::string::npos ? spec.size() + 1 : end + 1;
+        *field[f] = -1;
+        if (part.empty() || part == "*") continue;
+        const char* const* names = f ? fpu_vector_class_names : fpu_vector_op_names;
+        int n = f ? 7 : 4;
+        for (int i = 0; i < n; ++i)
+            if (part == names[i]) *field[f] = i;
+        if (*field[f] < 0) return false;
+    }
+    return pos > spec.size();
+}
+
+// The index words that follow count vectors
+static inline uint64_t fpu_vector_index_words(uint64_t count) { return FPU_VECTOR_BUCKETS + 1 + count; }
+
+// Bucket starts followed by vector numbers, as stored after the records
+static inline std::vector<uint32_t> fpu_vector_build_index(const std::vector<fpu_vector_t>& v) {
+    std::vector<uint32_t> idx(fpu_vector_index_words(v.size()), 0);
+    uint32_t* start = idx.data();
+    uint32_t* order = start + FPU_VECTOR_BUCKETS + 1;
+    for (const fpu_vector_t& t : v) ++start[fpu_vector_bucket(t) + 1];
+    for (unsigned k = 0; k < FPU_VECTOR_BUCKETS; ++k) start[k + 1] += start[k];
+    std::vector<uint32_t> fill(start, start + FPU_VECTOR_BUCKETS);
+    for (size_t i = 0; i < v.size(); ++i) order[fill[fpu_vector_bucket(v[i])]++] = (uint32_t)i;
+    return idx;
+}
+
+enum fpu_vector_status {
+    FPU_VECTOR_NOT_RUN = 0,
+    FPU_VECTOR_PASS,
+    FPU_VECTOR_FAIL,
+    FPU_VECTOR_DONE             // no expected value to check against
+};
+
+static const char* const fpu_vector_status_names[] = {"not_run", "pass", "fail", "done"};
+
+struct fpu_vector_result_t {
+    uint32_t result;
+    uint8_t  exceptions;        // fp_exceptions bits
+    uint8_t  status;            // fpu_vector_status
+    uint8_t  reserved[2];
+};
+
+// Writes the records and their class index. The vector number is 32 bits
+// wide in the index (and as VectorDriver's pc), so count must fit in one.
+static inline bool fpu_vector_write_file(const std::string& path, const std::vector<fpu_vector_t>& v) {
+    if (v.size() > UINT32_MAX) return false;
+    std::vector<uint32_t> idx = fpu_vector_build_index(v);
+    fpu_vector_header_t h;
+    std::memcpy(h.magic, FPU_VECTOR_MAGIC, sizeof(h.magic));
+    h.version     = FPU_VECTOR_VERSION;
+    h.record_size = sizeof(fpu_vector_t);
+    h.count       = v.size();
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(&h, sizeof(h), 1, f) == 1 && std::fwrite(v.data(), sizeof(fpu_vector_t), v.size(), f) == v.size() &&
+              std::fwrite(idx.data(), sizeof(uint32_t), idx.size(), f) == idx.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+// One vector or result file mapped into memory, unmapped on destruction
+class fpu_vector_map {
+public:
+    fpu_vector_map() : base(nullptr), size(0) {}
+    ~fpu_vector_map() { unmap(); }
+    fpu_vector_map(const fpu_vector_map&) = delete;
+    fpu_vector_map& operator=(const fpu_vector_map&) = delete;
+
+    // Read-only
+    bool open_vectors(const std::string& path, std::string& error) {
+        return open(path, FPU_VECTOR_MAGIC, FPU_VECTOR_VERSION, sizeof(fpu_vector_t), error);
+    }
+    bool open_results(const std::string& path, std::string& error) {
+        return open(path, FPU_RESULT_MAGIC, FPU_RESULT_VERSION, sizeof(fpu_vector_result_t), error);
+    }
+
+    // Creates (or truncates) a result file for count vectors, mapped shared
+    // so that the records land in the file as they are written
+    bool create_results(const std::string& path, uint64_t count, std::string& error) {
+        unmap();
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) { error = "cannot create " + path; return false; }
+        size_t bytes = sizeof(fpu_vector_header_t) + count * sizeof(fpu_vector_result_t);
+        if (ftruncate(fd, (off_t)bytes) != 0) {
+            close(fd);
+            error = "cannot size " + path;
+            return false;
+        }
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) { error = "cannot mmap " + path; return false; }
+        base = p;
+        size = bytes;
+        fpu_vector_header_t* h = header();
+        std::memcpy(h->magic, FPU_RESULT_MAGIC, sizeof(h->magic));
+        h->version     = FPU_RESULT_VERSION;
+        h->record_size = sizeof(fpu_vector_result_t);
+        h->count       = count;
+        return true;
+    }
+
+    uint64_t                   count() const { return header()->count; }
+    const fpu_vector_t*        vectors() const { return reinterpret_cast<const fpu_vector_t*>(header() + 1); }
+    fpu_vector_result_t*       results() { return reinterpret_cast<fpu_vector_result_t*>(header() + 1); }
+    const fpu_vector_result_t* results() const { return reinterpret_cast<const fpu_vector_result_t*>(header() + 1); }
+
+    // Class index of a vector file: the numbers of the vectors in bucket k
+    // (fpu_vector_bucket()) are bucket_begin(k) .. bucket_end(k)
+    const uint32_t* index() const { return reinterpret_cast<const uint32_t*>(vectors() + count()); }
+    const uint32_t* bucket_begin(unsigned k) const { return index() + FPU_VECTOR_BUCKETS + 1 + index()[k]; }
+    const uint32_t* bucket_end(unsigned k) const { return index() + FPU_VECTOR_BUCKETS + 1 + index()[k + 1]; }
+
+    // Numbers of the vectors matching opcode, class of a and class of b in
+    // file order; a negative argument matches anything
+    std::vector<uint32_t> select(int opcode, int class_a, int class_b) const {
+        std::vector<uint32_t> out;
+        for (unsigned op = 0; op < 4; ++op)
+            for (unsigned ca = 0; ca < FPU_VECTOR_CLASSES; ++ca)
+                for (unsigned cb = 0; cb < FPU_VECTOR_CLASSES; ++cb) {
+                    if ((opcode >= 0 && (unsigned)opcode != op) || (class_a >= 0 && (unsigned)class_a != ca) ||
+                        (class_b >= 0 && (unsigned)class_b != cb))
+                        continue;
+                    unsigned k = fpu_vector_bucket(op, ca, cb);
+                    out.insert(out.end(), bucket_begin(k), bucket_end(k));
+                }
+        std::sort(out.begin(), out.end());
+        while (!out.empty() && out.back() >= count()) out.pop_back();
+        return out;
+    }
+
+private:
+    fpu_vector_header_t* header() const { return static_cast<fpu_vector_header_t*>(base); }
+
+    bool open(const std::string& path, const char* magic, uint32_t version, size_t record_size, std::string& error) {
+        unmap();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) { error = "cannot open " + path; return false; }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(fpu_vector_header_t)) {
+            close(fd);
+            error = path + ": not an FPU vector file";
+            return false;
+        }
+        void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) { error = "cannot mmap " + path; return false; }
+        base = p;
+        size = st.st_size;
+
+        const fpu_vector_header_t* h = header();
+        bool vector_file = magic == FPU_VECTOR_MAGIC;
+        // Vector files carry a 4-byte index word per vector after the records
+        size_t per_record = record_size + (vector_file ? sizeof(uint32_t) : 0);
+        size_t fixed      = sizeof(*h) + (vector_file ? (FPU_VECTOR_BUCKETS + 1) * sizeof(uint32_t) : 0);
+        bool ok = std::memcmp(h->magic, magic, sizeof(h->magic)) == 0 && h->version == version &&
+                  h->record_size == record_size && size >= fixed && h->count <= (size - fixed) / per_record;
+        if (ok && vector_file) {
+            // The index must cover every vector exactly once, in range
+            const uint32_t* start = index();
+            ok = start[0] == 0 && start[FPU_VECTOR_BUCKETS] == h->count;
+            for (unsigned k = 0; ok && k < FPU_VECTOR_BUCKETS; ++k) ok = start[k] <= start[k + 1];
+        }
+        if (!ok) {
+            unmap();
+            error = path + ": not a version " + std::to_string(version) + " " + (vector_file ? "vector" : "result") +
+                    " file";
+            return false;
+        }
+        return true;
+    }
+
+    void unmap() {
+        if (base) munmap(base, size);
+        base = nullptr;
+        size = 0;
+    }
+
+    void*  base;
+    size_t size;
+};
+
+#endif // FPU_VECTOR_FILE_H
@@ -0,0 +1,209 @@
+#ifndef INST_TRACE_H
+#define INST_TRACE_H
+
+// Opt-in per-instruction lifecycle tracer for the pipelined core.
+// Every stage transition is pushed into a lock-free ring as a 16-byte record
+// and a background thread streams the ring to a binary file. Decode the file
+// with src/Tools/trace_decode. Simulation only, compiled out under ICSC or
+// with -DFPU_NO_INST_TRACE.
+//
+// File layout: inst_trace_header_t followed by inst_trace_record_t records,
+// both little-endian host order.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <unordered_map>
+#include "src/Common/spsc_ring.h"
+
+enum inst_trace_event {
+    TRACE_FETCH = 0,   // instruction word leaves Fetch
+    TRACE_DECODE,      // operands read, aux = opcode
+    TRACE_EXECUTE,     // enters Execute pipe[0], aux = opcode
+    TRACE_DIV_ENQUEUE, // FDIV allocated a divider slot, aux = slot
+    TRACE_DIV_DROP,    // FDIV discarded, no free divider slot
+    TRACE_DIV_DONE,    // division result won the result port, aux = slot
+    TRACE_WRITEBACK,   // register file written, aux = rd
+    TRACE_EX1,         // Execute operands decomposed
+    TRACE_EX2,         // Execute result packed (non-divide ops)
+    TRACE_STALL,       // external stall cycle, not tied to an instruction (pc = 0)
+    TRACE_EVENT_NUM
+};
+
+static const char* const inst_trace_event_names[TRACE_EVENT_NUM] = {
+    "fetch", "decode", "execute", "div_enqueue", "div_drop", "div_done",
+    "writeback", "ex1", "ex2", "stall"
+};
+
+static const char     INST_TRACE_MAGIC[8]  = {'F', 'P', 'U', 'T', 'R', 'A', 'C', 'E'};
+static const uint32_t INST_TRACE_VERSION   = 3;
+
+struct inst_trace_header_t {
+    char     magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t clock_period;   // in the same ticks as inst_trace_record_t::time
+};
+
+struct inst_trace_record_t {
+    uint64_t time;           // sc_time_stamp().value()
+    uint32_t pc;
+    uint8_t  event;          // inst_trace_event
+    uint8_t  aux;
+    uint16_t reserved;
+};
+
+// Pairs stage events with in-flight instructions. The same PC can be in
+// flight more than once after the program wraps, so each event goes to the
+// oldest instance at that PC that has not seen it yet.
+template <class Info>
+class inst_trace_matcher {
+public:
+    struct entry {
+        Info     info;
+        uint32_t seen;   // bit per inst_trace_event
+    };
+
+    entry& fetch(uint32_t pc) {
+        std::deque<entry>& q = inflight[pc];
+        q.push_back(entry());
+        q.back().info = Info();
+        q.back().seen = 1u << TRACE_FETCH;
+        return q.back();
+    }
+
+    // nullptr when no instance is waiting for the event (e.g. trace started mid-flight)
+    entry* match(uint32_t pc, unsigned event) {
+        typename std::unordered_map<uint32_t, std::deque<entry>>::iterator q = inflight.find(pc);
+        if (q == inflight.end()) return nullptr;
+        for (entry& e : q->second) {
+            if (!(e.seen & (1u << event))) {
+                e.seen |= 1u << event;
+                return &e;
+            }
+        }
+        return nullptr;
+    }
+
+    void retire(uint32_t pc, const entry* e) {
+        std::deque<entry>& q = inflight[pc];
+        for (typename std::deque<entry>::iterator it = q.begin(); it != q.end(); ++it) {
+            if (&*it == e) { q.erase(it); break; }
+        }
+        if (q.empty()) inflight.erase(pc);
+    }
+
+    template <class F>
+    void for_each(F f) {
+        for (auto& kv : inflight) for (entry& e : kv.second) f(e);
+    }
+
+    size_t in_flight() const {
+        size_t n = 0;
+        for (const auto& kv : inflight) n += kv.second.size();
+        return n;
+    }
+
+private:
+    std::unordered_map<uint32_t, std::deque<entry>> inflight;
+};
+
+class InstTracer {
+public:
+    // Starts tracing to path; clock_period is one cycle in kernel ticks
+    static bool start(const char* path, uint64_t clock_period, size_t capacity = 1 << 20) {
+        if (s_active) return false;
+        FILE* f = std::fopen(path, "wb");
+        if (!f) return false;
+        s_active = new InstTracer(f, clock_period, capacity);
+        return true;
+    }
+
+    // Drains the ring, closes the file and returns the number of records written
+    static uint64_t stop() {
+        if (!s_active) return 0;
+        s_active->push_batch();
+        uint64_t n = s_active->recorded;
+        delete s_active;
+        s_active = nullptr;
+        return n;
+    }
+
+    static InstTracer* active() { return s_active; }
+
+    void record(uint64_t time, uint32_t pc, uint8_t event, uint8_t aux) {
+        inst_trace_record_t& r = batch[batched];
+        r.time     = time;
+        r.pc       = pc;
+        r.event    = event;
+        r.aux      = aux;
+        r.reserved = 0;
+        if (++batched == BATCH) push_batch();
+    }
+
+private:
+    // Records reach the ring a block at a time, so the atomics and the
+    // writer's cache-line traffic are paid once per BATCH records
+    static const size_t BATCH = 256;
+
+    void push_batch() {
+        for (size_t done_n = 0; done_n < batched;) {
+            size_t n = ring.try_push_n(batch + done_n, batched - done_n);
+            // Ring full: the writer is behind, wait instead of losing records
+            if (!n) std::this_thread::yield();
+            done_n += n;
+        }
+        recorded += batched;
+        batched = 0;
+    }
+
+    InstTracer(FILE* f, uint64_t clock_period, size_t capacity)
+        : file(f), ring(capacity), done(false), recorded(0), batched(0) {
+        std::setvbuf(file, nullptr, _IOFBF, 1 << 20);
+        inst_trace_header_t h;
+        std::memcpy(h.magic, INST_TRACE_MAGIC, sizeof(h.magic));
+        h.version      = INST_TRACE_VERSION;
+        h.record_size  = sizeof(inst_trace_record_t);
+        h.clock_period = clock_period;
+        std::fwrite(&h, sizeof(h), 1, file);
+        writer = std::thread(&InstTracer::flush_loop, this);
+    }
+
+    ~InstTracer() {
+        done.store(true, std::memory_order_release);
+        writer.join();
+        std::fclose(file);
+    }
+
+    void flush_loop() {
+        for (;;) {
+            bool last = done.load(std::memory_order_acquire);
+            const inst_trace_record_t* p;
+            size_t n;
+            bool wrote = false;
+            while ((n = ring.peek(&p)) != 0) {
+                std::fwrite(p, sizeof(*p), n, file);
+                ring.consume(n);
+                wrote = true;
+            }
+            if (last) break;
+            if (!wrote) std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+
+    FILE*                            file;
+    spsc_ring<inst_trace_record_t>   ring;
+    std::atomic<bool>                done;
+    uint64_t                         recorded;
+    inst_trace_record_t              batch[BATCH];
+    size_t                           batched;
+    std::thread                      writer;
+
+    static inline InstTracer* s_active = nullptr;
+};
+
+#endif // INST_TRACE_H
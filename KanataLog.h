@@ -0,0 +1,146 @@
+#ifndef KANATA_LOG_H
+#define KANATA_LOG_H
+
+// Opt-in Kanata (version 0004) pipeline log for the pipelined core, for
+// viewing in Konata. Driven by the same stage hooks as InstTrace.h; each
+// instruction gets a lane with stages F, D, X0, X1, then X2 or DIV, and WB.
+// Dropped FDIVs are flushed with the drop reason as a label.
+// Simulation only, compiled out under ICSC or with -DFPU_NO_INST_TRACE.
+
+#include "InstTrace.h"
+#include <cinttypes>
+#include <vector>
+
+class KanataLog {
+public:
+    // Starts logging to path; clock_period is one cycle in kernel ticks
+    static bool start(const char* path, uint64_t clock_period) {
+        if (s_active) return false;
+        FILE* f = std::fopen(path, "w");
+        if (!f) return false;
+        s_active = new KanataLog(f, clock_period);
+        return true;
+    }
+
+    static void stop() {
+        delete s_active;
+        s_active = nullptr;
+    }
+
+    static KanataLog* active() { return s_active; }
+
+    void record(uint64_t time, uint32_t pc, uint8_t event, uint8_t aux) {
+        advance(time / clock_period);
+
+        if (event == TRACE_STALL) {
+            insts.for_each([](entry_t& e) { ++e.info.stalls; });
+            return;
+        }
+        if (event == TRACE_FETCH) {
+            entry_t& e = insts.fetch(pc);
+            e.info.id = next_id++;
+            std::fprintf(file, "I\t%" PRIu64 "\t%" PRIu64 "\t0\n", e.info.id, e.info.id);
+            std::fprintf(file, "L\t%" PRIu64 "\t0\t%08x: \n", e.info.id, pc);
+            stage(e, "F");
+            return;
+        }
+
+        entry_t* e = insts.match(pc, event);
+        if (!e) return;
+        uint64_t id = e->info.id;
+
+        switch (event) {
+            case TRACE_DECODE:
+                std::fprintf(file, "L\t%" PRIu64 "\t0\t%s\n", id, aux < 4 ? op_names[aux] : "op?");
+                stage(*e, "D");
+                break;
+            case TRACE_EXECUTE: stage(*e, "X0"); break;
+            case TRACE_EX1:     stage(*e, "X1"); break;
+            case TRACE_EX2:     stage(*e, "X2"); break;
+            case TRACE_DIV_ENQUEUE:
+                std::fprintf(file, "L\t%" PRIu64 "\t0\t [slot %u]\n", id, (unsigned)aux);
+                stage(*e, "DIV");
+                break;
+            case TRACE_DIV_DONE:
+                std::fprintf(file, "L\t%" PRIu64 "\t1\tdivider slot %u won the result port at cycle %" PRIu64 "\n",
+                             id, (unsigned)aux, cycle);
+                break;
+            case TRACE_DIV_DROP:
+                flush(*e, "dropped: all divider slots busy");
+                insts.retire(pc, e);
+                break;
+            case TRACE_WRITEBACK:
+                stage(*e, "WB");
+                if (e->info.stalls)
+                    std::fprintf(file, "L\t%" PRIu64 "\t0\t [stall x%u]\n", id, e->info.stalls);
+                // Retire on the next cycle so WB is drawn one cycle wide
+                retiring.push_back(id);
+                insts.retire(pc, e);
+                break;
+        }
+    }
+
+private:
+    struct inst_t {
+        uint64_t    id;
+        unsigned    stalls;      // external stall cycles seen while in flight
+        const char* stage;       // current stage, ended when the next one starts
+    };
+    typedef inst_trace_matcher<inst_t>::entry entry_t;
+
+    KanataLog(FILE* f, uint64_t period)
+        : file(f), clock_period(period ? period : 1), cycle(0), started(false), next_id(0), next_retire(0) {
+        std::setvbuf(file, nullptr, _IOFBF, 1 << 20);
+        std::fputs("Kanata\t0004\n", file);
+    }
+
+    ~KanataLog() {
+        advance(cycle + 1);
+        std::fclose(file);
+    }
+
+    void advance(uint64_t now) {
+        if (!started) {
+            std::fprintf(file, "C=\t%" PRIu64 "\n", now);
+            started = true;
+            cycle = now;
+            return;
+        }
+        if (now <= cycle) return;
+        std::fprintf(file, "C\t1\n");
+        for (uint64_t id : retiring) {
+            std::fprintf(file, "E\t%" PRIu64 "\t0\tWB\n", id);
+            std::fprintf(file, "R\t%" PRIu64 "\t%" PRIu64 "\t0\n", id, next_retire++);
+        }
+        retiring.clear();
+        if (now > cycle + 1) std::fprintf(file, "C\t%" PRIu64 "\n", now - cycle - 1);
+        cycle = now;
+    }
+
+    void stage(entry_t& e, const char* name) {
+        if (e.info.stage) std::fprintf(file, "E\t%" PRIu64 "\t0\t%s\n", e.info.id, e.info.stage);
+        std::fprintf(file, "S\t%" PRIu64 "\t0\t%s\n", e.info.id, name);
+        e.info.stage = name;
+    }
+
+    void flush(entry_t& e, const char* reason) {
+        std::fprintf(file, "L\t%" PRIu64 "\t0\t [%s]\n", e.info.id, reason);
+        std::fprintf(file, "L\t%" PRIu64 "\t1\t%s\n", e.info.id, reason);
+        if (e.info.stage) std::fprintf(file, "E\t%" PRIu64 "\t0\t%s\n", e.info.id, e.info.stage);
+        std::fprintf(file, "R\t%" PRIu64 "\t%" PRIu64 "\t1\n", e.info.id, next_retire++);
+    }
+
+    FILE*                       file;
+    uint64_t                    clock_period;
+    uint64_t                    cycle;
+    bool                        started;
+    uint64_t                    next_id;
+    uint64_t                    next_retire;
+    std::vector<uint64_t>       retiring;
+    inst_trace_matcher<inst_t>  insts;
+
+    static constexpr const char* op_names[4] = {"fadd", "fsub", "fmul", "fdiv"};
+    static inline KanataLog* s_active = nullptr;
+};
+
+#endif // KANATA_LOG_H
@@ -0,0 +1,1396 @@
+#ifndef PIPELINED_FPU_UNITS_PROCESSOR_H
+#define PIPELINED_FPU_UNITS_PROCESSOR_H
+
+#include <systemc.h>
+#include <cmath>
+#include <iomanip>
+#include <cstring>
+using namespace std;
+#ifdef SC_INCLUDE_FX
+#undef SC_INCLUDE_FX
+#endif
+
+// Instruction lifecycle hooks, feeding the binary trace (InstTrace.h) and the
+// Kanata pipeline log (KanataLog.h), plus the Spike-format commit log
+// (src/Common/commit_log.h). A no-op until one of them is started.
+#if !defined(__SC_TOOL__) && !defined(FPU_NO_INST_TRACE)
+#include "KanataLog.h"
+#include "src/Common/commit_log.h"
+#define FPU_TRACE(ev, pc, aux)                                                                             \
+    do {                                                                                                   \
+        if (InstTracer* tr_ = InstTracer::active())                                                        \
+            tr_->record(sc_time_stamp().value(), (uint32_t)(pc), (ev), (uint8_t)(aux));                   \
+        if (KanataLog* kl_ = KanataLog::active())                                                          \
+            kl_->record(sc_time_stamp().value(), (uint32_t)(pc), (ev), (uint8_t)(aux));                   \
+    } while (0)
+#define FPU_COMMIT(pc, rd, value, exc)                                                                     \
+    do {                                                                                                   \
+        if (CommitLog* cl_ = CommitLog::active())                                                          \
+            cl_->commit((uint32_t)(pc), 0, (unsigned)(rd), (uint32_t)(value), fp_exceptions_to_fflags(exc)); \
+    } while (0)
+// An FDIV in a divider slot writes back after younger instructions; the
+// commit log numbers instructions as they enter Execute and holds the
+// younger ones back, so its lines stay in program order
+#define FPU_COMMIT_ISSUE(pc)                                                                               \
+    do {                                                                                                   \
+        if (CommitLog* cl_ = CommitLog::active()) cl_->issue((uint32_t)(pc));                              \
+    } while (0)
+#define FPU_COMMIT_EXPECT(pc)                                                                              \
+    do {                                                                                                   \
+        if (CommitLog* cl_ = CommitLog::active()) cl_->expect((uint32_t)(pc));                             \
+    } while (0)
+#else
+#define FPU_TRACE(ev, pc, aux) do {} while (0)
+#define FPU_COMMIT(pc, rd, value, exc) do {} while (0)
+#define FPU_COMMIT_ISSUE(pc) do {} while (0)
+#define FPU_COMMIT_EXPECT(pc) do {} while (0)
+#endif
+
+#ifndef __SC_TOOL__
+#include "Checkpoint.h"
+#endif
+
+enum fp_exceptions {
+    FP_INVALID_OP     = 0x1,
+    FP_OVERFLOW       = 0x2,
+    FP_UNDERFLOW      = 0x4,
+    FP_DIVIDE_BY_ZERO = 0x8,
+    FP_INEXACT        = 0x10
+};
+
+#if !defined(__SC_TOOL__) && !defined(FPU_NO_INST_TRACE)
+// fp_exceptions bits -> RISC-V fflags (NV DZ OF UF NX) for the commit log
+static inline uint32_t fp_exceptions_to_fflags(sc_uint<8> exc) {
+    uint32_t f = 0;
+    if (exc & FP_INVALID_OP)     f |= FFLAGS_NV;
+    if (exc & FP_DIVIDE_BY_ZERO) f |= FFLAGS_DZ;
+    if (exc & FP_OVERFLOW)       f |= FFLAGS_OF;
+    if (exc & FP_UNDERFLOW)      f |= FFLAGS_UF;
+    if (exc & FP_INEXACT)        f |= FFLAGS_NX;
+    return f;
+}
+#endif
+
+// Number of in-flight divisions Execute can hold
+static const int FPU_DIV_SLOTS = 4;
+
+// Performance counter CSR map (read with Decode::read_perf_counter)
+enum perf_counter_id {
+    PERF_CYCLES = 0,          // cycles out of reset
+    PERF_FETCHED,             // instructions accepted from Fetch
+    PERF_RETIRED_FADD,        // retired per opcode
+    PERF_RETIRED_FSUB,
+    PERF_RETIRED_FMUL,
+    PERF_RETIRED_FDIV,
+    PERF_RETIRED_OTHER,
+    PERF_STALL_CYCLES,        // external stall asserted
+    PERF_DIV_FULL_CYCLES,     // all divider slots busy
+    PERF_DIV_OCCUPANCY,       // sum of busy divider slots per cycle
+    PERF_DIV_DROPPED,         // FDIV discarded, no free divider slot
+    PERF_DIV_LATE,            // cycles a finished division waited for the result port
+    PERF_EXC_INVALID,         // retired instructions raising each flag
+    PERF_EXC_OVERFLOW,
+    PERF_EXC_UNDERFLOW,
+    PERF_EXC_DIVIDE_BY_ZERO,
+    PERF_EXC_INEXACT,
+    PERF_COUNTER_NUM
+};
+
+static const char* const perf_counter_names[PERF_COUNTER_NUM] = {
+    "cycles", "fetched", "retired_fadd", "retired_fsub", "retired_fmul",
+    "retired_fdiv", "retired_other", "stall_cycles", "div_full_cycles",
+    "div_occupancy", "div_dropped", "div_late",
+    "exc_invalid", "exc_overflow", "exc_underflow", "exc_divide_by_zero",
+    "exc_inexact"
+};
+
+struct ieee754_components {
+    bool        sign;
+    sc_uint<8>  exponent;
+    sc_uint<23> mantissa;
+    bool is_zero;
+    bool is_infinity;
+    bool is_nan;
+    bool is_denormalized;
+    sc_uint<24> effective_mantissa; // with hidden 1 when normalized
+};
+
+#ifndef __SC_TOOL__
+template <class Ar>
+static inline void checkpoint_io(Ar& ar, ieee754_components& c) {
+    ar.io(c.sign);
+    ar.io(c.exponent);
+    ar.io(c.mantissa);
+    ar.io(c.is_zero);
+    ar.io(c.is_infinity);
+    ar.io(c.is_nan);
+    ar.io(c.is_denormalized);
+    ar.io(c.effective_mantissa);
+}
+#endif
+
+static inline ieee754_components decompose_ieee754_rtl(sc_uint<32> value) {
+    ieee754_components comp;
+    comp.sign     = value[31];
+    comp.exponent = (value >> 23) & 0xFF;
+    comp.mantissa = value & 0x7FFFFF;
+
+    comp.is_zero         = (comp.exponent == 0) && (comp.mantissa == 0);
+    comp.is_infinity     = (comp.exponent == 0xFF) && (comp.mantissa == 0);
+    comp.is_nan          = (comp.exponent == 0xFF) && (comp.mantissa != 0);
+    comp.is_denormalized = (comp.exponent == 0) && (comp.mantissa != 0);
+
+    if (comp.is_zero || comp.is_infinity || comp.is_nan) {
+        comp.effective_mantissa = comp.mantissa;
+    } else if (comp.is_denormalized) {
+        comp.effective_mantissa = comp.mantissa;
+    } else {
+        comp.effective_mantissa = comp.mantissa | 0x800000; // add hidden 1
+    }
+    return comp;
+}
+
+static inline sc_uint<32> compose_ieee754_rtl(bool sign, sc_int<12> exp_signed, sc_uint<24> mantissa, sc_uint<8>& exceptions) {
+    // Overflow to infinity
+    if (exp_signed >= 255) {
+        exceptions |= FP_OVERFLOW;
+        return (sc_uint<32>(sign) << 31) | 0x7F800000;
+    }
+
+    // Subnormal / underflow path
+    if (exp_signed <= 0) {
+        // create a denormal when in range and mantissa != 0
+        if (exp_signed >= -22 && mantissa != 0) {
+            exceptions |= FP_UNDERFLOW;
+            int shift_amount = 1 - exp_signed.to_int();
+            if (shift_amount > 0 && shift_amount < 24) {
+                sc_uint<24> m = mantissa >> shift_amount;
+                if (m == 0) {
+                    return (sc_uint<32>(sign) << 31);
+                }
+                return (sc_uint<32>(sign) << 31) | (m & 0x7FFFFF);
+            }
+        }
+        exceptions |= FP_UNDERFLOW;
+        return (sc_uint<32>(sign) << 31);
+    }
+
+    sc_uint<8>  exp  = sc_uint<8>(exp_signed);
+    sc_uint<23> frac = mantissa & 0x7FFFFF;
+    return (sc_uint<32>(sign) << 31) | (sc_uint<32>(exp) << 23) | sc_uint<32>(frac);
+}
+
+static inline sc_uint<32> generate_nan_rtl(bool sign = false) {
+    return (sc_uint<32>(sign) << 31) | 0x7FC00000;
+}
+static inline sc_uint<32> generate_infinity_rtl(bool sign = false) {
+    return (sc_uint<32>(sign) << 31) | 0x7F800000;
+}
+
+struct fp_instruction_t {
+    sc_uint<4>  opcode;
+    sc_uint<5>  rd;
+    sc_uint<5>  rs1;
+    sc_uint<5>  rs2;
+    sc_uint<13> unused;
+
+    fp_instruction_t() : opcode(0), rd(0), rs1(0), rs2(0), unused(0) {}
+    fp_instruction_t(sc_uint<4> op, sc_uint<5> dst, sc_uint<5> src1, sc_uint<5> src2)
+        : opcode(op), rd(dst), rs1(src1), rs2(src2), unused(0) {}
+
+    sc_uint<32> to_word() const {
+        return (sc_uint<32>(opcode) << 28) | (sc_uint<32>(rd) << 23) |
+               (sc_uint<32>(rs1) << 18) | (sc_uint<32>(rs2) << 13);
+    }
+};
+
+// Stage-to-stage interfaces. Each travels as one sc_signal, so a stage's
+// outputs cost one update per clock instead of one per field. A stage that
+// holds (stall) does not write; one with nothing to pass on clears valid and
+// leaves the other fields as they were. ICSC takes these as record
+// channels; operator<< and sc_trace are what sc_signal<T> requires.
+struct fetch_to_decode_t {
+    sc_uint<32> pc;
+    sc_uint<32> instruction;
+    bool        valid;
+
+    fetch_to_decode_t() : pc(0), instruction(0), valid(false) {}
+
+    bool operator==(const fetch_to_decode_t& o) const {
+        return pc == o.pc && instruction == o.instruction && valid == o.valid;
+    }
+};
+
+struct decode_to_execute_t {
+    sc_uint<32> pc;
+    sc_uint<4>  opcode;
+    sc_uint<5>  rd;
+    sc_uint<32> operand1;
+    sc_uint<32> operand2;
+    bool        valid;
+
+    decode_to_execute_t() : pc(0), opcode(0), rd(0), operand1(0), operand2(0), valid(false) {}
+
+    bool operator==(const decode_to_execute_t& o) const {
+        return pc == o.pc && opcode == o.opcode && rd == o.rd && operand1 == o.operand1 &&
+               operand2 == o.operand2 && valid == o.valid;
+    }
+};
+
+struct execute_to_wb_t {
+    sc_uint<32> pc;
+    sc_uint<4>  opcode;
+    sc_uint<5>  rd;
+    sc_uint<32> result;
+    sc_uint<8>  exceptions;
+    bool        valid;
+
+    execute_to_wb_t() : pc(0), opcode(0), rd(0), result(0), exceptions(0), valid(false) {}
+
+    bool operator==(const execute_to_wb_t& o) const {
+        return pc == o.pc && opcode == o.opcode && rd == o.rd && result == o.result &&
+               exceptions == o.exceptions && valid == o.valid;
+    }
+};
+
+static inline ostream& operator<<(ostream& os, const fetch_to_decode_t& v) {
+    return os << hex << "{pc=0x" << v.pc << " inst=0x" << v.instruction << dec << " valid=" << v.valid << "}";
+}
+static inline ostream& operator<<(ostream& os, const decode_to_execute_t& v) {
+    return os << hex << "{pc=0x" << v.pc << dec << " op=" << v.opcode << " rd=f" << v.rd << hex << " a=0x"
+              << v.operand1 << " b=0x" << v.operand2 << dec << " valid=" << v.valid << "}";
+}
+static inline ostream& operator<<(ostream& os, const execute_to_wb_t& v) {
+    return os << hex << "{pc=0x" << v.pc << dec << " op=" << v.opcode << " rd=f" << v.rd << hex << " result=0x"
+              << v.result << " exc=0x" << v.exceptions << dec << " valid=" << v.valid << "}";
+}
+
+static inline void sc_trace(sc_trace_file* tf, const fetch_to_decode_t& v, const std::string& name) {
+    sc_trace(tf, v.pc, name + ".pc");
+    sc_trace(tf, v.instruction, name + ".instruction");
+    sc_trace(tf, v.valid, name + ".valid");
+}
+static inline void sc_trace(sc_trace_file* tf, const decode_to_execute_t& v, const std::string& name) {
+    sc_trace(tf, v.pc, name + ".pc");
+    sc_trace(tf, v.opcode, name + ".opcode");
+    sc_trace(tf, v.rd, name + ".rd");
+    sc_trace(tf, v.operand1, name + ".operand1");
+    sc_trace(tf, v.operand2, name + ".operand2");
+    sc_trace(tf, v.valid, name + ".valid");
+}
+static inline void sc_trace(sc_trace_file* tf, const execute_to_wb_t& v, const std::string& name) {
+    sc_trace(tf, v.pc, name + ".pc");
+    sc_trace(tf, v.opcode, name + ".opcode");
+    sc_trace(tf, v.rd, name + ".rd");
+    sc_trace(tf, v.result, name + ".result");
+    sc_trace(tf, v.exceptions, name + ".exceptions");
+    sc_trace(tf, v.valid, name + ".valid");
+}
+
+#ifndef __SC_TOOL__
+// Field order matches the separate signals the bundles replaced, so
+// snapshots keep their layout
+template <class Ar>
+static inline void checkpoint_io(Ar& ar, fetch_to_decode_t& v) {
+    ar.io(v.pc);
+    ar.io(v.instruction);
+    ar.io(v.valid);
+}
+template <class Ar>
+static inline void checkpoint_io(Ar& ar, decode_to_execute_t& v) {
+    ar.io(v.pc);
+    ar.io(v.opcode);
+    ar.io(v.rd);
+    ar.io(v.operand1);
+    ar.io(v.operand2);
+    ar.io(v.valid);
+}
+template <class Ar>
+static inline void checkpoint_io(Ar& ar, execute_to_wb_t& v) {
+    ar.io(v.pc);
+    ar.io(v.result);
+    ar.io(v.opcode);
+    ar.io(v.rd);
+    ar.io(v.exceptions);
+    ar.io(v.valid);
+}
+#endif
+
+SC_MODULE(Fetch) {
+    sc_in<bool> clk;
+    sc_in<bool> reset;
+    sc_in<bool> stall;
+
+    sc_out<fetch_to_decode_t> out;
+
+    // Fixed-size ROM for synthesis. Size can be adjusted.
+    sc_uint<32> imem[256];
+    sc_uint<9>  imem_size;
+    sc_uint<32> pc;
+
+    // Simulation-only helper (not used by synth tools)
+    void load_program(const sc_uint<32>* program, int size) {
+        int s = (size > 256) ? 256 : size;
+        for (int i = 0; i < s; ++i) imem[i] = program[i];
+        imem_size = s;
+    }
+
+    void fetch_process() {
+        if (reset.read()) {
+            pc = 0;
+            out.write(fetch_to_decode_t());
+        } else if (!stall.read()) {
+            fetch_to_decode_t f = out.read();
+            if (pc < imem_size) {
+                f.pc          = pc * 4;
+                f.instruction = imem[pc];
+                f.valid       = true;
+                FPU_TRACE(TRACE_FETCH, pc * 4, 0);
+                pc = pc + 1;
+            } else {
+                f.valid = false;
+            }
+            out.write(f);
+        }
+    }
+
+#ifndef __SC_TOOL__
+    // Checkpoint.h: save or restore everything the stage holds
+    template <class Ar> void checkpoint_state(Ar& ar) {
+        ar.begin_section("FTCH");
+        for (int i = 0; i < 256; ++i) ar.io(imem[i]);
+        ar.io(imem_size);
+        ar.io(pc);
+        ar.end_section();
+    }
+#endif
+
+    SC_CTOR(Fetch) : imem_size(0), pc(0) {
+        // Initialize ROM to zeros
+        for (int i = 0; i < 256; ++i) imem[i] = 0;
+        SC_METHOD(fetch_process);
+        sensitive << clk.pos();
+    }
+};
+
+// Floating-point register file: READ_PORTS combinational read ports and
+// WRITE_PORTS write ports taking effect on the rising edge. Reads are
+// write-first, so a register written this cycle reads as its new value and
+// Decode sees a result in the same cycle Writeback retires it. When two
+// ports write one register the higher port wins; f0 ignores writes. The
+// accrued exception flags live here too, ORed in by each write port.
+template <unsigned READ_PORTS, unsigned WRITE_PORTS>
+struct RegisterFile_t : public sc_module {
+    sc_in<bool> clk;
+    sc_in<bool> reset;
+
+    sc_in<sc_uint<5>>   raddr[READ_PORTS];
+    sc_out<sc_uint<32>> rdata[READ_PORTS];
+
+    sc_in<bool>         we[WRITE_PORTS];
+    sc_in<sc_uint<5>>   waddr[WRITE_PORTS];
+    sc_in<sc_uint<32>>  wdata[WRITE_PORTS];
+    sc_in<sc_uint<8>>   wflags[WRITE_PORTS];
+
+    sc_signal<sc_uint<32>> regs[32];
+    sc_signal<sc_uint<8>>  flags;
+#ifndef __SC_TOOL__
+    sc_event               read_refresh;   // an addressed register was written
+#endif
+
+    void read_process() {
+        for (unsigned r = 0; r < READ_PORTS; ++r) {
+            sc_uint<5>  a = raddr[r].read();
+            sc_uint<32> v = regs[a.to_uint()].read();
+            for (unsigned w = 0; w < WRITE_PORTS; ++w) {
+                if (we[w].read() && waddr[w].read() == a && a != 0) v = wdata[w].read();
+            }
+            rdata[r].write(v);
+        }
+    }
+
+    void write_process() {
+#ifndef __SC_TOOL__
+        bool refresh = false;
+#endif
+        if (reset.read()) {
+            for (int i = 0; i < 32; ++i) regs[i].write(0);
+            flags.write(0);
+#ifndef __SC_TOOL__
+            refresh = true;
+#endif
+        } else {
+            sc_uint<8> f = flags.read();
+#ifndef __SC_TOOL__
+            if (flags_clear_pending) f = 0;
+#endif
+            for (unsigned w = 0; w < WRITE_PORTS; ++w) {
+                if (we[w].read()) {
+                    if (waddr[w].read() != 0) regs[waddr[w].read().to_uint()].write(wdata[w].read());
+                    f |= wflags[w].read();
+#ifndef __SC_TOOL__
+                    refresh = refresh || addressed(waddr[w].read());
+#endif
+                }
+            }
+#ifndef __SC_TOOL__
+            f |= flags_set;
+#endif
+            flags.write(f);
+        }
+#ifndef __SC_TOOL__
+        for (int i = 1; i < 32; ++i) {
+            if (load_pending[i]) {
+                regs[i].write(load_value[i]);
+                refresh = refresh || addressed(i);
+            }
+            load_pending[i] = false;
+        }
+        if (reset.read()) flags.write(flags_set);
+        flags_set = 0;
+        flags_clear_pending = false;
+        if (refresh) read_refresh.notify(SC_ZERO_TIME);
+#endif
+    }
+
+#ifndef __SC_TOOL__
+    // Testbench access. Loads reach the registers on the next rising edge,
+    // after reset's clear, so write_process stays the only writer of regs.
+    sc_uint<32> load_value[32];
+    bool        load_pending[32];
+    sc_uint<8>  flags_set;
+    bool        flags_clear_pending;
+
+    // Whether a read port is addressing register i
+    bool addressed(sc_uint<5> i) const {
+        for (unsigned r = 0; r < READ_PORTS; ++r)
+            if (raddr[r].read() == i) return true;
+        return false;
+    }
+
+    void set_register_bits(int reg, sc_uint<32> bits) {
+        if (reg > 0 && reg < 32) {
+            load_value[reg]   = bits;
+            load_pending[reg] = true;
+        }
+    }
+    sc_uint<32> read_register(int reg) const {
+        if (reg < 0 || reg >= 32) return 0;
+        return load_pending[reg] ? load_value[reg] : regs[reg].read();
+    }
+
+    // Flag changes are applied on the next rising edge together with that
+    // edge's writeback flags: a clear first, then everything raised is ORed
+    // in, so a flag set by the testbench and one retired on the same edge
+    // both survive
+    void set_exception_flag(sc_uint<8> flag) { flags_set |= flag; }
+    sc_uint<8> get_exception_flags() const { return (flags_clear_pending ? sc_uint<8>(0) : flags.read()) | flags_set; }
+    void clear_exception_flags() {
+        flags_set = 0;
+        flags_clear_pending = true;
+    }
+
+    template <class Ar> void checkpoint_state(Ar& ar) {
+        ar.begin_section("REGF");
+        for (int i = 0; i < 32; ++i) {
+            ar.io(regs[i]);
+            ar.io(load_value[i]);
+            ar.io(load_pending[i]);
+        }
+        ar.io(flags);
+        ar.io(flags_set);
+        ar.io(flags_clear_pending);
+        ar.end_section();
+    }
+#endif
+
+    SC_HAS_PROCESS(RegisterFile_t);
+
+    RegisterFile_t(sc_module_name name) : sc_module(name) {
+#ifndef __SC_TOOL__
+        for (int i = 0; i < 32; ++i) {
+            load_value[i]   = 0;
+            load_pending[i] = false;
+        }
+        flags_set = 0;
+        flags_clear_pending = false;
+#endif
+        SC_METHOD(read_process);
+        for (unsigned r = 0; r < READ_PORTS; ++r) sensitive << raddr[r];
+        for (unsigned w = 0; w < WRITE_PORTS; ++w) sensitive << we[w] << waddr[w] << wdata[w];
+#ifdef __SC_TOOL__
+        for (int i = 0; i < 32; ++i) sensitive << regs[i];
+#else
+        // Only writes to an addressed register wake the read ports
+        sensitive << read_refresh;
+#endif
+
+        SC_METHOD(write_process);
+        sensitive << clk.pos();
+    }
+};
+
+// Two reads for Decode, one write from Writeback
+typedef RegisterFile_t<2, 1> RegisterFile;
+
+SC_MODULE(Decode) {
+    sc_in<bool> clk;
+    sc_in<bool> reset;
+    sc_in<bool> stall;
+
+    sc_in<fetch_to_decode_t>    in;
+    sc_out<decode_to_execute_t> out;
+
+    // RegisterFile read ports, addressed straight from the incoming instruction
+    sc_out<sc_uint<5>>  rs1_addr_out;
+    sc_out<sc_uint<5>>  rs2_addr_out;
+    sc_in<sc_uint<32>>  rs1_data_in;
+    sc_in<sc_uint<32>>  rs2_data_in;
+
+    // Retirement and divider status from Execute, for the performance counters
+    sc_in<execute_to_wb_t> retire_in;
+    sc_in<sc_uint<3>>   div_busy_in;
+    sc_in<bool>         div_dropped_in;
+    sc_in<bool>         div_late_in;
+
+    sc_uint<64> perf_counters[PERF_COUNTER_NUM];
+
+    void regfile_addr_process() {
+        sc_uint<32> inst = in.read().instruction;
+        rs1_addr_out.write((inst >> 18) & 0x1F);
+        rs2_addr_out.write((inst >> 13) & 0x1F);
+    }
+
+    void update_perf_counters() {
+        perf_counters[PERF_CYCLES] = perf_counters[PERF_CYCLES] + 1;
+        if (stall.read()) {
+            perf_counters[PERF_STALL_CYCLES] = perf_counters[PERF_STALL_CYCLES] + 1;
+        } else {
+            if (in.read().valid) perf_counters[PERF_FETCHED] = perf_counters[PERF_FETCHED] + 1;
+            const execute_to_wb_t& retire = retire_in.read();
+            if (retire.valid) {
+                unsigned op = retire.opcode.to_uint();
+                unsigned id = (op < 4) ? (PERF_RETIRED_FADD + op) : (unsigned)PERF_RETIRED_OTHER;
+                perf_counters[id] = perf_counters[id] + 1;
+
+                sc_uint<8> exc = retire.exceptions;
+                for (int i = 0; i < 5; ++i) {
+                    if (exc[i]) perf_counters[PERF_EXC_INVALID + i] = perf_counters[PERF_EXC_INVALID + i] + 1;
+                }
+            }
+        }
+
+        sc_uint<3> busy = div_busy_in.read();
+        perf_counters[PERF_DIV_OCCUPANCY] = perf_counters[PERF_DIV_OCCUPANCY] + busy;
+        if (busy == FPU_DIV_SLOTS) perf_counters[PERF_DIV_FULL_CYCLES] = perf_counters[PERF_DIV_FULL_CYCLES] + 1;
+        if (div_dropped_in.read()) perf_counters[PERF_DIV_DROPPED] = perf_counters[PERF_DIV_DROPPED] + 1;
+        if (div_late_in.read()) perf_counters[PERF_DIV_LATE] = perf_counters[PERF_DIV_LATE] + 1;
+    }
+
+    void decode_process() {
+        if (reset.read()) {
+            out.write(decode_to_execute_t());
+            for (int i = 0; i < PERF_COUNTER_NUM; i++) perf_counters[i] = 0;
+        } else {
+            update_perf_counters();
+
+            if (!stall.read()) {
+                const fetch_to_decode_t& f = in.read();
+                decode_to_execute_t d = out.read();
+                if (f.valid) {
+                    sc_uint<32> inst = f.instruction;
+                    d.pc       = f.pc;
+                    d.opcode   = (inst >> 28) & 0xF;
+                    d.rd       = (inst >> 23) & 0x1F;
+                    d.operand1 = rs1_data_in.read();
+                    d.operand2 = rs2_data_in.read();
+                    d.valid    = true;
+                    FPU_TRACE(TRACE_DECODE, f.pc, d.opcode);
+                } else {
+                    d.valid = false;
+                }
+                out.write(d);
+            }
+        }
+    }
+
+    sc_uint<64> read_perf_counter(unsigned id) const {
+        return (id < PERF_COUNTER_NUM) ? perf_counters[id] : sc_uint<64>(0);
+    }
+
+#ifndef __SC_TOOL__
+    template <class Ar> void checkpoint_state(Ar& ar) {
+        ar.begin_section("DECD");
+        ar.expect(PERF_COUNTER_NUM, "performance counter count");
+        for (int i = 0; i < PERF_COUNTER_NUM; ++i) ar.io(perf_counters[i]);
+        ar.end_section();
+    }
+#endif
+
+    SC_CTOR(Decode) {
+        for (int i = 0; i < PERF_COUNTER_NUM; i++) perf_counters[i] = 0;
+        SC_METHOD(decode_process);
+        sensitive << clk.pos();
+        SC_METHOD(regfile_addr_process);
+        sensitive << in;
+    }
+};
+
+// Split points of Execute's arithmetic (FPU_EXEC_SPLITS). Each set bit puts
+// a pipeline register after that phase:
+//   DECOMPOSE  operand fields and classes
+//   PREPARE    special cases, then exponent alignment (add/sub) or the
+//              24x17 + 24x7 partial products (mul, one DSP48 slice each)
+//   COMBINE    significand add/subtract or partial-product reduction
+//   NORMALIZE  leading-one shift, before packing the result
+// Execute is 2 + popcount(splits) stages deep; the default, DECOMPOSE only,
+// is the original 3-stage pipe. Results do not depend on the splits: a
+// division that finishes while the last stage holds a result waits for
+// the next free cycle on the result port.
+enum exec_split {
+    EXEC_SPLIT_DECOMPOSE = 0x1,
+    EXEC_SPLIT_PREPARE   = 0x2,
+    EXEC_SPLIT_COMBINE   = 0x4,
+    EXEC_SPLIT_NORMALIZE = 0x8
+};
+
+#ifndef FPU_EXEC_SPLITS
+#define FPU_EXEC_SPLITS EXEC_SPLIT_DECOMPOSE
+#endif
+
+template <unsigned SPLITS>
+struct Execute_t : public sc_module {
+    static_assert(SPLITS < 0x10, "FPU_EXEC_SPLITS takes exec_split bits only");
+
+    // pipe[0] latches the inputs, pipe[DEPTH - 1] holds the result
+    static const unsigned DEPTH = 2 + (SPLITS & 1) + ((SPLITS >> 1) & 1) + ((SPLITS >> 2) & 1) + ((SPLITS >> 3) & 1);
+
+    sc_in<bool> clk;
+    sc_in<bool> reset;
+    sc_in<bool> stall;
+
+    sc_in<decode_to_execute_t> in;
+    sc_out<execute_to_wb_t>    out;
+
+    // Divider status for Decode's performance counters
+    sc_out<sc_uint<3>>  div_busy_out;
+    sc_out<bool>        div_dropped_out;
+    sc_out<bool>        div_late_out;
+
+private:
+    enum opcodes { OP_FADD = 0x0, OP_FSUB = 0x1, OP_FMUL = 0x2, OP_FDIV = 0x3 };
+    enum phases { PH_DECOMPOSE = 0, PH_PREPARE, PH_COMBINE, PH_NORMALIZE, PH_PACK, PH_NUM };
+
+    struct stage_t {
+        sc_uint<32> pc;
+        sc_uint<4>  opcode;
+        sc_uint<5>  rd;
+        sc_uint<32> operand_a;
+        sc_uint<32> operand_b;
+        bool        valid;
+
+        // decoded components (registered)
+        ieee754_components comp_a, comp_b;
+
+        // arithmetic in progress between split points
+        bool        done;       // result final (special case or packed)
+        bool        rsign;
+        sc_int<12>  rexp;
+        sc_uint<24> mant_a, mant_b;   // aligned significands (add/sub)
+        sc_uint<48> acc;              // sum, product or low partial product
+        sc_uint<31> acc_hi;           // high partial product (mul)
+
+        // results
+        sc_uint<32> result;
+        sc_uint<8>  exceptions;
+
+        stage_t() : pc(0), opcode(0), rd(0), operand_a(0), operand_b(0), valid(false), comp_a(), comp_b(),
+                    done(false), rsign(false), rexp(0), mant_a(0), mant_b(0), acc(0), acc_hi(0),
+                    result(0), exceptions(0) {}
+    };
+
+    stage_t pipe[DEPTH];
+
+    // Index of the pipe register that holds the outcome of phase p
+    static unsigned phase_stage(unsigned p) {
+        unsigned s = 1;
+        for (unsigned i = 0; i < p; ++i) if ((SPLITS >> i) & 1) s++;
+        return s;
+    }
+
+    // ---------------- Division unit pool (fixed, synthesizable) ----------------
+    struct div_entry_t {
+        bool        valid;
+        sc_uint<32> pc;
+        sc_uint<4>  opcode;
+        sc_uint<5>  rd;
+        ieee754_components a, b;
+
+        // iterative restoring division state
+        bool        div_sign;
+        sc_int<12>  div_exp;
+        sc_uint<48> dividend;    // shifted numerator
+        sc_uint<24> divisor;     // denominator
+        sc_uint<24> quotient;    // building result
+        sc_int<6>   cycles;      // 24 down to 0
+        sc_uint<32> result;
+        sc_uint<8>  exceptions;
+
+        div_entry_t() : valid(false), opcode(0), rd(0), a(), b(), div_sign(0), div_exp(0), dividend(0),
+                        divisor(0), quotient(0), cycles(0), result(0), exceptions(0) {}
+    };
+
+    static const int DIV_SLOTS = FPU_DIV_SLOTS;
+    div_entry_t divq[DIV_SLOTS];
+
+    int find_free_divslot() {
+        for (int i = 0; i < DIV_SLOTS; ++i) if (!divq[i].valid) return i;
+        return -1;
+    }
+    int find_ready_divslot() {
+        for (int i = 0; i < DIV_SLOTS; ++i) {
+            if (divq[i].valid && divq[i].cycles == 0) return i;
+        }
+        return -1;
+    }
+    int count_ready_divslots() {
+        int n = 0;
+        for (int i = 0; i < DIV_SLOTS; ++i) if (divq[i].valid && divq[i].cycles == 0) n++;
+        return n;
+    }
+    sc_uint<3> count_busy_divslots() {
+        sc_uint<3> n = 0;
+        for (int i = 0; i < DIV_SLOTS; ++i) if (divq[i].valid) n++;
+        return n;
+    }
+
+    void div_start(div_entry_t& e) {
+        const ieee754_components &a = e.a, &b = e.b;
+
+        if (a.is_nan || b.is_nan) { e.exceptions |= FP_INVALID_OP; e.result = generate_nan_rtl(); e.cycles = 0; return; }
+        if (b.is_zero) {
+            e.exceptions |= FP_DIVIDE_BY_ZERO;
+            if (a.is_zero) { e.exceptions |= FP_INVALID_OP; e.result = generate_nan_rtl(); }
+            else { e.result = generate_infinity_rtl(a.sign ^ b.sign); }
+            e.cycles = 0; return;
+        }
+        if (a.is_zero) { e.result = sc_uint<32>(a.sign ^ b.sign) << 31; e.cycles = 0; return; }
+        if (a.is_infinity) {
+            if (b.is_infinity) { e.exceptions |= FP_INVALID_OP; e.result = generate_nan_rtl(); }
+            else { e.result = generate_infinity_rtl(a.sign ^ b.sign); }
+            e.cycles = 0; return;
+        }
+        if (b.is_infinity) { e.result = sc_uint<32>(a.sign ^ b.sign) << 31; e.cycles = 0; return; }
+
+        e.div_sign = a.sign ^ b.sign;
+        sc_int<12> ea = a.is_denormalized ? sc_int<12>(1) : sc_int<12>(a.exponent);
+        sc_int<12> eb = b.is_denormalized ? sc_int<12>(1) : sc_int<12>(b.exponent);
+        e.div_exp = ea - eb + 127;
+
+        e.dividend = sc_uint<48>(a.effective_mantissa) << 23;
+        e.divisor  = b.effective_mantissa;
+        e.quotient = 0;
+        e.cycles   = 24;
+    }
+
+    void div_step(div_entry_t& e) {
+        if (!e.valid || e.cycles <= 0) return;
+
+        e.dividend = e.dividend << 1;
+        sc_uint<48> dsh = sc_uint<48>(e.divisor) << 24;
+        if (e.dividend >= dsh) {
+            e.dividend = e.dividend - dsh;
+            e.quotient = (e.quotient << 1) | 1;
+        } else {
+            e.quotient = e.quotient << 1;
+        }
+
+        e.cycles = e.cycles - 1;
+
+        if (e.cycles == 0) {
+            sc_uint<24> q = e.quotient;
+            sc_int<12>  ex = e.div_exp;
+
+            // Normalize (bounded loop for synthesis)
+            for (int i = 0; i < 24; ++i) {
+                if ((q == 0) || (q & 0x800000) || (ex <= 1)) break;
+                q <<= 1;
+                ex = ex - 1;
+            }
+
+            e.result = compose_ieee754_rtl(e.div_sign, ex, q, e.exceptions);
+        }
+    }
+
+    void addsub_phase(unsigned p, stage_t& s, bool subtract) {
+        const ieee754_components &a = s.comp_a, &b_in = s.comp_b;
+        bool bsign_eff = subtract ? !b_in.sign : b_in.sign;
+
+        if (p == PH_PREPARE) {
+            // Handle NaNs/Infs/Zeros
+            s.done = true;
+            if (a.is_nan || b_in.is_nan) {
+                s.exceptions |= FP_INVALID_OP;
+                s.result = generate_nan_rtl();
+                return;
+            }
+            if (a.is_infinity || b_in.is_infinity) {
+                if (a.is_infinity && b_in.is_infinity && (a.sign != bsign_eff)) {
+                    s.exceptions |= FP_INVALID_OP;
+                    s.result = generate_nan_rtl();
+                    return;
+                }
+                s.result = a.is_infinity
+                    ? ((sc_uint<32>(a.sign) << 31) | 0x7F800000)
+                    : ((sc_uint<32>(bsign_eff) << 31) | 0x7F800000);
+                return;
+            }
+            if (a.is_zero && b_in.is_zero) {
+                bool rsign = subtract ? (a.sign && !b_in.sign) : (a.sign && b_in.sign);
+                s.result = sc_uint<32>(rsign) << 31;
+                return;
+            }
+            if (a.is_zero) {
+                s.result = (sc_uint<32>(bsign_eff) << 31) | (sc_uint<32>(b_in.exponent) << 23) | b_in.mantissa;
+                return;
+            }
+            if (b_in.is_zero) {
+                s.result = (sc_uint<32>(a.sign) << 31) | (sc_uint<32>(a.exponent) << 23) | a.mantissa;
+                return;
+            }
+            s.done = false;
+
+            // Align the smaller operand to the larger exponent
+            sc_int<12> exp_a = a.is_denormalized ? sc_int<12>(1) : sc_int<12>(a.exponent);
+            sc_int<12> exp_b = b_in.is_denormalized ? sc_int<12>(1) : sc_int<12>(b_in.exponent);
+            sc_uint<24> mant_a = a.is_denormalized ? (sc_uint<24>)a.mantissa : (sc_uint<24>)(a.mantissa | 0x800000);
+            sc_uint<24> mant_b = b_in.is_denormalized ? (sc_uint<24>)b_in.mantissa : (sc_uint<24>)(b_in.mantissa | 0x800000);
+
+            sc_int<12> diff = exp_a - exp_b;
+            if (diff >= 0) {
+                s.rexp = exp_a;
+                int sh = diff.to_int();
+                if (sh > 0 && sh < 24) mant_b >>= sh;
+                else if (sh >= 24) mant_b = 0;
+            } else {
+                s.rexp = exp_b;
+                int sh = -diff.to_int();
+                if (sh > 0 && sh < 24) mant_a >>= sh;
+                else if (sh >= 24) mant_a = 0;
+            }
+            s.mant_a = mant_a;
+            s.mant_b = mant_b;
+        } else if (p == PH_COMBINE) {
+            sc_uint<25> rmant;
+            if (a.sign == bsign_eff) {
+                rmant = sc_uint<25>(s.mant_a) + sc_uint<25>(s.mant_b);
+                s.rsign = a.sign;
+            } else if (s.mant_a >= s.mant_b) {
+                rmant = sc_uint<25>(s.mant_a) - sc_uint<25>(s.mant_b);
+                s.rsign = a.sign;
+            } else {
+                rmant = sc_uint<25>(s.mant_b) - sc_uint<25>(s.mant_a);
+                s.rsign = bsign_eff;
+            }
+            if (rmant == 0) {
+                s.result = 0;
+                s.done = true;
+            }
+            s.acc = rmant;
+        } else if (p == PH_NORMALIZE) {
+            sc_uint<25> rmant = s.acc;
+            if (rmant & 0x1000000) { // carry
+                rmant >>= 1;
+                s.rexp = s.rexp + 1;
+            } else {
+                // shift left until MSB hits bit23 or exponent underflows to 1
+                for (int i = 0; i < 24; ++i) {
+                    if ((rmant & 0x800000) || (s.rexp <= 1)) break;
+                    rmant <<= 1;
+                    s.rexp = s.rexp - 1;
+                }
+            }
+            s.acc = rmant & 0x7FFFFF;
+        } else {
+            s.result = compose_ieee754_rtl(s.rsign, s.rexp, sc_uint<24>(s.acc), s.exceptions);
+            s.done = true;
+        }
+    }
+
+    void mul_phase(unsigned p, stage_t& s) {
+        const ieee754_components &a = s.comp_a, &b = s.comp_b;
+
+        if (p == PH_PREPARE) {
+            s.done = true;
+            if (a.is_nan || b.is_nan) { s.exceptions |= FP_INVALID_OP; s.result = generate_nan_rtl(); return; }
+            if ((a.is_infinity && b.is_zero) || (a.is_zero && b.is_infinity)) {
+                s.exceptions |= FP_INVALID_OP;
+                s.result = generate_nan_rtl();
+                return;
+            }
+            if (a.is_infinity || b.is_infinity) { s.result = generate_infinity_rtl(a.sign ^ b.sign); return; }
+            if (a.is_zero || b.is_zero) { s.result = sc_uint<32>(a.sign ^ b.sign) << 31; return; }
+            s.done = false;
+
+            s.rsign = a.sign ^ b.sign;
+            sc_int<12> ea = a.is_denormalized ? sc_int<12>(1) : sc_int<12>(a.exponent);
+            sc_int<12> eb = b.is_denormalized ? sc_int<12>(1) : sc_int<12>(b.exponent);
+            s.rexp = ea + eb - 127;
+
+            // B split at bit 17 so each product fits a 25x18 DSP multiplier
+            s.acc    = sc_uint<48>(a.effective_mantissa) * sc_uint<17>(b.effective_mantissa.range(16, 0));
+            s.acc_hi = sc_uint<31>(a.effective_mantissa) * sc_uint<7>(b.effective_mantissa.range(23, 17));
+        } else if (p == PH_COMBINE) {
+            s.acc = s.acc + (sc_uint<48>(s.acc_hi) << 17);
+        } else if (p == PH_NORMALIZE) {
+            sc_uint<48> prod = s.acc;
+            if (prod & 0x800000000000ULL) { // bit 47
+                prod >>= 24;
+                s.rexp = s.rexp + 1;
+            } else {
+                prod >>= 23;
+            }
+            s.acc = prod & 0xFFFFFF;
+        } else {
+            s.result = compose_ieee754_rtl(s.rsign, s.rexp, sc_uint<24>(s.acc), s.exceptions);
+            s.done = true;
+        }
+    }
+
+    // Applies one phase of the arithmetic to a stage register
+    void exec_phase(unsigned p, stage_t& s) {
+        if (p == PH_DECOMPOSE) {
+            s.comp_a = decompose_ieee754_rtl(s.operand_a);
+            s.comp_b = decompose_ieee754_rtl(s.operand_b);
+            s.exceptions = 0;
+            s.done = false;
+            return;
+        }
+        if (s.done) return;
+        switch (s.opcode.to_uint()) {
+            case OP_FADD: addsub_phase(p, s, false); break;
+            case OP_FSUB: addsub_phase(p, s, true); break;
+            case OP_FMUL: mul_phase(p, s); break;
+            case OP_FDIV: s.result = 0; s.done = true; break;
+            default: s.exceptions |= FP_INVALID_OP; s.result = generate_nan_rtl(); s.done = true; break;
+        }
+    }
+
+    // Hands a decomposed FDIV to a free divider slot; false when all are busy
+    bool div_dispatch(const stage_t& s) {
+        int slot = find_free_divslot();
+        if (slot < 0) return false;
+        divq[slot] = div_entry_t();
+        divq[slot].valid   = true;
+        divq[slot].pc      = s.pc;
+        divq[slot].opcode  = s.opcode;
+        divq[slot].rd      = s.rd;
+        divq[slot].a       = s.comp_a;
+        divq[slot].b       = s.comp_b;
+        divq[slot].exceptions = 0;
+        div_start(divq[slot]);
+        FPU_TRACE(TRACE_DIV_ENQUEUE, s.pc, slot);
+        FPU_COMMIT_EXPECT(s.pc);
+        return true;
+    }
+
+public:
+#ifndef __SC_TOOL__
+    // Functional model of one instruction: the same arithmetic as the
+    // pipeline, without timing. Used to fast-forward between detailed windows.
+    sc_uint<32> evaluate(sc_uint<4> opc, sc_uint<32> op_a, sc_uint<32> op_b, sc_uint<8>& exc) {
+        stage_t s;
+        s.opcode    = opc;
+        s.operand_a = op_a;
+        s.operand_b = op_b;
+        exec_phase(PH_DECOMPOSE, s);
+        if (opc != OP_FDIV) {
+            for (unsigned p = PH_PREPARE; p < PH_NUM; ++p) exec_phase(p, s);
+            exc |= s.exceptions;
+            return s.result;
+        }
+
+        div_entry_t e;
+        e.valid = true;
+        e.a     = s.comp_a;
+        e.b     = s.comp_b;
+        div_start(e);
+        while (e.cycles > 0) div_step(e);
+        exc |= e.exceptions;
+        return e.result;
+    }
+#endif
+
+    void exec_process() {
+        const unsigned last = DEPTH - 1;
+
+        if (reset.read()) {
+            for (unsigned i = 0; i < DEPTH; ++i) pipe[i] = stage_t();
+            for (int i = 0; i < DIV_SLOTS; ++i) divq[i] = div_entry_t();
+
+            out.write(execute_to_wb_t());
+            div_busy_out.write(0);
+            div_dropped_out.write(false);
+            div_late_out.write(false);
+            return;
+        }
+
+        // If stalled, still advance division micro-steps
+        // but do not change pipe registers or outputs.
+        if (stall.read()) {
+            FPU_TRACE(TRACE_STALL, 0, 0);
+            for (int i = 0; i < DIV_SLOTS; ++i) if (divq[i].valid && divq[i].cycles > 0) div_step(divq[i]);
+            execute_to_wb_t held = out.read();
+            held.valid = false;
+            out.write(held);
+            div_busy_out.write(count_busy_divslots());
+            div_dropped_out.write(false);
+            div_late_out.write(false);
+            return;
+        }
+
+
+        for (int i = 0; i < DIV_SLOTS; ++i) if (divq[i].valid && divq[i].cycles > 0) div_step(divq[i]);
+
+        // 2) Drive outputs: the last stage first, since the pipe cannot hold
+        // its result, otherwise a ready division. A finished division keeps
+        // its slot until the port is free (div_late), so no result is lost
+        // whatever the depth.
+        execute_to_wb_t o;
+        int ready_idx = pipe[last].valid ? -1 : find_ready_divslot();
+        bool div_late = count_ready_divslots() > (ready_idx >= 0 ? 1 : 0);
+        bool div_dropped = false;
+        if (pipe[last].valid) {
+            o.valid      = true;
+            o.pc         = pipe[last].pc;
+            o.opcode     = pipe[last].opcode;
+            o.rd         = pipe[last].rd;
+            o.result     = pipe[last].result;
+            o.exceptions = pipe[last].exceptions;
+        } else if (ready_idx >= 0) {
+            o.valid      = true;
+            o.pc         = divq[ready_idx].pc;
+            o.opcode     = divq[ready_idx].opcode;
+            o.rd         = divq[ready_idx].rd;
+            o.result     = divq[ready_idx].result;
+            o.exceptions = divq[ready_idx].exceptions;
+            divq[ready_idx].valid = false; // free the slot
+            FPU_TRACE(TRACE_DIV_DONE, o.pc, ready_idx);
+        }
+        out.write(o);
+
+        // 3) Advance the arithmetic stages, oldest first. Each stage applies
+        // the phases that end at its register; FDIV leaves for the divider
+        // pool once its operands are decomposed.
+        for (int k = last; k > 0; --k) {
+            if (!pipe[k - 1].valid) {
+                pipe[k].valid = false;
+                continue;
+            }
+            pipe[k] = pipe[k - 1];
+            for (unsigned p = 0; p < PH_NUM; ++p) {
+                if (phase_stage(p) != (unsigned)k) continue;
+                if (p == PH_PREPARE && pipe[k].opcode == OP_FDIV) {
+                    // enqueue a division if slot available; otherwise it is dropped
+                    if (!div_dispatch(pipe[k])) {
+                        div_dropped = true;
+                        FPU_TRACE(TRACE_DIV_DROP, pipe[k].pc, 0);
+                    }
+                    pipe[k].valid = false;
+                    break;
+                }
+                exec_phase(p, pipe[k]);
+                if (p == PH_DECOMPOSE) FPU_TRACE(TRACE_EX1, pipe[k].pc, 0);
+                if (p == PH_PACK) FPU_TRACE(TRACE_EX2, pipe[k].pc, 0);
+            }
+        }
+
+        // 4) Input -> Stage 0
+        const decode_to_execute_t& d = in.read();
+        if (d.valid) {
+            pipe[0].pc        = d.pc;
+            pipe[0].opcode    = d.opcode;
+            pipe[0].rd        = d.rd;
+            pipe[0].operand_a = d.operand1;
+            pipe[0].operand_b = d.operand2;
+            pipe[0].valid     = true;
+            FPU_TRACE(TRACE_EXECUTE, pipe[0].pc, pipe[0].opcode);
+            FPU_COMMIT_ISSUE(pipe[0].pc);
+        } else {
+            pipe[0].valid = false;
+        }
+
+        div_busy_out.write(count_busy_divslots());
+        div_dropped_out.write(div_dropped);
+        div_late_out.write(div_late);
+    }
+
+#ifndef __SC_TOOL__
+    template <class Ar> void checkpoint_state(Ar& ar) {
+        ar.begin_section("EXEC");
+        ar.expect(DEPTH, "execute depth");
+        for (unsigned i = 0; i < DEPTH; ++i) {
+            stage_t& s = pipe[i];
+            ar.io(s.pc);
+            ar.io(s.opcode);
+            ar.io(s.rd);
+            ar.io(s.operand_a);
+            ar.io(s.operand_b);
+            ar.io(s.valid);
+            checkpoint_io(ar, s.comp_a);
+            checkpoint_io(ar, s.comp_b);
+            ar.io(s.done);
+            ar.io(s.rsign);
+            ar.io(s.rexp);
+            ar.io(s.mant_a);
+            ar.io(s.mant_b);
+            ar.io(s.acc);
+            ar.io(s.acc_hi);
+            ar.io(s.result);
+            ar.io(s.exceptions);
+        }
+        ar.expect(DIV_SLOTS, "divider slot count");
+        for (int i = 0; i < DIV_SLOTS; ++i) {
+            div_entry_t& e = divq[i];
+            ar.io(e.valid);
+            ar.io(e.pc);
+            ar.io(e.opcode);
+            ar.io(e.rd);
+            checkpoint_io(ar, e.a);
+            checkpoint_io(ar, e.b);
+            ar.io(e.div_sign);
+            ar.io(e.div_exp);
+            ar.io(e.dividend);
+            ar.io(e.divisor);
+            ar.io(e.quotient);
+            ar.io(e.cycles);
+            ar.io(e.result);
+            ar.io(e.exceptions);
+        }
+        ar.end_section();
+    }
+#endif
+
+    SC_HAS_PROCESS(Execute_t);
+
+    Execute_t(sc_module_name name) : sc_module(name) {
+        for (unsigned i = 0; i < DEPTH; ++i) pipe[i] = stage_t();
+        for (int i = 0; i < DIV_SLOTS; ++i) divq[i] = div_entry_t();
+        SC_METHOD(exec_process);
+        sensitive << clk.pos();
+    }
+};
+
+typedef Execute_t<FPU_EXEC_SPLITS> Execute;
+
+SC_MODULE(Writeback) {
+    sc_in<bool> clk;
+    sc_in<bool> reset;
+    sc_in<bool> stall;
+
+    sc_in<execute_to_wb_t> in;
+
+    // RegisterFile write port, committed on the next rising edge
+    sc_out<bool>        we_out;
+    sc_out<sc_uint<5>>  waddr_out;
+    sc_out<sc_uint<32>> wdata_out;
+    sc_out<sc_uint<8>>  wflags_out;
+
+    void writeback_process() {
+        const execute_to_wb_t& e = in.read();
+        we_out.write(!reset.read() && !stall.read() && e.valid);
+        waddr_out.write(e.rd);
+        wdata_out.write(e.result);
+        wflags_out.write(e.exceptions);
+    }
+
+#ifndef __SC_TOOL__
+    void trace_process() {
+        const execute_to_wb_t& e = in.read();
+        if (!reset.read() && !stall.read() && e.valid) {
+            FPU_TRACE(TRACE_WRITEBACK, e.pc, e.rd);
+            FPU_COMMIT(e.pc, e.rd, e.result, e.exceptions);
+        }
+    }
+#endif
+
+    SC_CTOR(Writeback) {
+        SC_METHOD(writeback_process);
+        sensitive << reset << stall << in;
+#ifndef __SC_TOOL__
+        SC_METHOD(trace_process);
+        sensitive << clk.pos();
+#endif
+    }
+};
+
+
+
+SC_MODULE(FPU_Pipeline_Top) {
+    sc_in<bool> clk;
+    sc_in<bool> reset;
+    sc_in<bool> stall;
+
+    // Internal pipeline stage instances
+    Fetch*        fetch_stage;
+    Decode*       decode_stage;
+    Execute*      execute_stage;
+    Writeback*    writeback_stage;
+    RegisterFile* register_file;
+
+
+    sc_signal<fetch_to_decode_t>   fetch_to_decode;
+    sc_signal<decode_to_execute_t> decode_to_execute;
+    sc_signal<execute_to_wb_t>     execute_to_wb;
+
+    sc_signal<sc_uint<3>>  execute_div_busy;
+    sc_signal<bool>        execute_div_dropped, execute_div_late;
+
+    sc_signal<sc_uint<5>>  rf_rs1_addr, rf_rs2_addr, rf_waddr;
+    sc_signal<sc_uint<32>> rf_rs1_data, rf_rs2_data, rf_wdata;
+    sc_signal<bool>        rf_we;
+    sc_signal<sc_uint<8>>  rf_wflags;
+
+    SC_CTOR(FPU_Pipeline_Top) {
+
+        fetch_stage     = new Fetch("fetch");
+        decode_stage    = new Decode("decode");
+        execute_stage   = new Execute("execute");
+        writeback_stage = new Writeback("writeback");
+        register_file   = new RegisterFile("register_file");
+
+        fetch_stage->clk(clk);
+        fetch_stage->reset(reset);
+        fetch_stage->stall(stall);
+        fetch_stage->out(fetch_to_decode);
+
+        decode_stage->clk(clk);
+        decode_stage->reset(reset);
+        decode_stage->stall(stall);
+        decode_stage->in(fetch_to_decode);
+        decode_stage->out(decode_to_execute);
+        decode_stage->rs1_addr_out(rf_rs1_addr);
+        decode_stage->rs2_addr_out(rf_rs2_addr);
+        decode_stage->rs1_data_in(rf_rs1_data);
+        decode_stage->rs2_data_in(rf_rs2_data);
+        decode_stage->retire_in(execute_to_wb);
+        decode_stage->div_busy_in(execute_div_busy);
+        decode_stage->div_dropped_in(execute_div_dropped);
+        decode_stage->div_late_in(execute_div_late);
+
+        execute_stage->clk(clk);
+        execute_stage->reset(reset);
+        execute_stage->stall(stall);
+        execute_stage->in(decode_to_execute);
+        execute_stage->out(execute_to_wb);
+        execute_stage->div_busy_out(execute_div_busy);
+        execute_stage->div_dropped_out(execute_div_dropped);
+        execute_stage->div_late_out(execute_div_late);
+
+        writeback_stage->clk(clk);
+        writeback_stage->reset(reset);
+        writeback_stage->stall(stall);
+        writeback_stage->in(execute_to_wb);
+        writeback_stage->we_out(rf_we);
+        writeback_stage->waddr_out(rf_waddr);
+        writeback_stage->wdata_out(rf_wdata);
+        writeback_stage->wflags_out(rf_wflags);
+
+        register_file->clk(clk);
+        register_file->reset(reset);
+        register_file->raddr[0](rf_rs1_addr);
+        register_file->raddr[1](rf_rs2_addr);
+        register_file->rdata[0](rf_rs1_data);
+        register_file->rdata[1](rf_rs2_data);
+        register_file->we[0](rf_we);
+        register_file->waddr[0](rf_waddr);
+        register_file->wdata[0](rf_wdata);
+        register_file->wflags[0](rf_wflags);
+    }
+
+    // Simulation-only dump of Decode's performance counters
+    void dump_perf_counters(std::ostream& os) const {
+        os << "\n--- Performance Counters ---\n";
+        for (int i = 0; i < PERF_COUNTER_NUM; ++i) {
+            os << std::left << std::setw(20) << perf_counter_names[i] << std::right
+               << std::dec << decode_stage->read_perf_counter(i).to_uint64() << "\n";
+        }
+        uint64_t cycles = decode_stage->read_perf_counter(PERF_CYCLES).to_uint64();
+        if (cycles) {
+            os << std::left << std::setw(20) << "avg_div_occupancy" << std::right
+               << (double)decode_stage->read_perf_counter(PERF_DIV_OCCUPANCY).to_uint64() / cycles << "\n";
+        }
+    }
+
+#ifndef __SC_TOOL__
+    // Stage registers plus the inter-stage signals (the stage outputs)
+    template <class Ar> void checkpoint_state(Ar& ar) {
+        fetch_stage->checkpoint_state(ar);
+        decode_stage->checkpoint_state(ar);
+        execute_stage->checkpoint_state(ar);
+        register_file->checkpoint_state(ar);
+
+        ar.begin_section("SIGS");
+        ar.io(fetch_to_decode);
+        ar.io(decode_to_execute);
+        ar.io(execute_to_wb);
+        ar.io(execute_div_busy);
+        ar.io(execute_div_dropped);
+        ar.io(execute_div_late);
+        ar.io(rf_rs1_addr);
+        ar.io(rf_rs2_addr);
+        ar.io(rf_rs1_data);
+        ar.io(rf_rs2_data);
+        ar.io(rf_we);
+        ar.io(rf_waddr);
+        ar.io(rf_wdata);
+        ar.io(rf_wflags);
+        ar.end_section();
+    }
+
+    // Snapshot between sc_start() calls. Take it away from a clock edge, and
+    // resume it at the same clock phase.
+    void save_checkpoint(std::vector<uint8_t>& out) {
+        checkpoint_writer w(out, (uint64_t)(sc_time_stamp().to_seconds() * 1e12 + 0.5));
+        checkpoint_state(w);
+    }
+
+    // Validates the whole snapshot before touching any state
+    bool load_checkpoint(const std::vector<uint8_t>& in, std::string* error = nullptr) {
+        checkpoint_reader check(in, false);
+        checkpoint_state(check);
+        if (!check.ok()) {
+            if (error) *error = check.error();
+            return false;
+        }
+        checkpoint_reader r(in, true);
+        checkpoint_state(r);
+        return true;
+    }
+
+    bool save_checkpoint(const std::string& path) {
+        std::vector<uint8_t> buf;
+        save_checkpoint(buf);
+        return checkpoint_write_file(path, buf);
+    }
+
+    bool load_checkpoint(const std::string& path, std::string* error = nullptr) {
+        std::vector<uint8_t> buf;
+        if (!checkpoint_read_file(path, buf)) {
+            if (error) *error = "cannot read " + path;
+            return false;
+        }
+        return load_checkpoint(buf, error);
+    }
+#endif
+
+    ~FPU_Pipeline_Top() {
+        delete fetch_stage;
+        delete decode_stage;
+        delete execute_stage;
+        delete writeback_stage;
+        delete register_file;
+    }
+};
+
+#endif // PIPELINED_FPU_UNITS_PROCESSOR_H
@@ -1,4 +1,16 @@
-///Replace this code in lower part of the Piepline file to run and test it 
+// Standalone testbench for the pipelined FPU. Build it in place of
+// PipelinedFPUUnitsProcessor.cpp (it provides its own sc_main).
+//
+// Without arguments it runs the directed program below. With --vectors it
+// streams a golden vector database (FpuVectorFile.h, written by
+// fpu_vectors) through the whole core instead:
+//   Testbench --vectors db.fpv [--select OP:A:B] [--show N]
+// --select takes the buckets of the file's class index, e.g. fdiv:nan:* or
+// fmul:denormal:normal. Exits 1 if any vector fails.
+#include <deque>
+#include "PipelinedFPUUnitsProcessor.h"
+#include "FpuVectorFile.h"
+
 // ============================================================
 //                    TESTBENCH (Simulation Only)
 // ============================================================
@@ -31,6 +43,11 @@ SC_MODULE(ComprehensiveTestbench) {
     int tests_passed = 0;
     int tests_failed = 0;
 
+    // --vectors: the database and the vector numbers to run
+    const fpu_vector_map* db = nullptr;
+    std::vector<uint32_t> selection;
+    unsigned              show = 10;
+
     void create_program() {
         vector<sc_uint<32>> program;
 
@@ -62,33 +79,33 @@ SC_MODULE(ComprehensiveTestbench) {
 
     void setup_regs() {
         // f1=3.0f, f2=2.0f
-        fpu_top->decode_stage->set_register_bits(1, float_to_ieee754_bits(3.0f));
-        fpu_top->decode_stage->set_register_bits(2, float_to_ieee754_bits(2.0f));
+        fpu_top->register_file->set_register_bits(1, float_to_ieee754_bits(3.0f));
+        fpu_top->register_file->set_register_bits(2, float_to_ieee754_bits(2.0f));
 
         // Special
-        fpu_top->decode_stage->fp_registers[8]  = 0;            // zero
-        fpu_top->decode_stage->fp_registers[10] = 0x7F800000;   // +inf
-        fpu_top->decode_stage->fp_registers[11] = 0xFF800000;   // -inf
+        fpu_top->register_file->set_register_bits(8, 0);              // zero
+        fpu_top->register_file->set_register_bits(10, 0x7F800000);   // +inf
+        fpu_top->register_file->set_register_bits(11, 0xFF800000);   // -inf
 
         // Large (overflow when multiplied)
-        fpu_top->decode_stage->fp_registers[16] = 0x7F000000;
-        fpu_top->decode_stage->fp_registers[17] = 0x7F000000;
+        fpu_top->register_file->set_register_bits(16, 0x7F000000);
+        fpu_top->register_file->set_register_bits(17, 0x7F000000);
 
         // Tiny (underflow when multiplied)
-        fpu_top->decode_stage->fp_registers[13] = 0x00800000;
-        fpu_top->decode_stage->fp_registers[14] = 0x00800000;
+        fpu_top->register_file->set_register_bits(13, 0x00800000);
+        fpu_top->register_file->set_register_bits(14, 0x00800000);
 
         // Denorms
-        fpu_top->decode_stage->fp_registers[19] = 0x00400000;
-        fpu_top->decode_stage->fp_registers[20] = 0x00200000;
-        fpu_top->decode_stage->fp_registers[22] = 0x00100000;
-        fpu_top->decode_stage->fp_registers[23] = 0x3F800000; // 1.0f
+        fpu_top->register_file->set_register_bits(19, 0x00400000);
+        fpu_top->register_file->set_register_bits(20, 0x00200000);
+        fpu_top->register_file->set_register_bits(22, 0x00100000);
+        fpu_top->register_file->set_register_bits(23, 0x3F800000); // 1.0f
 
         cout << "\nTest register setup complete.\n";
     }
 
     bool check_result_f(int reg, float expected, const string& name) {
-        float actual = ieee754_bits_to_float(fpu_top->decode_stage->fp_registers[reg]);
+        float actual = ieee754_bits_to_float(fpu_top->register_file->read_register(reg));
         bool pass = fabs(actual - expected) < 1e-6f;
         cout << name << ": f" << reg << " = " << actual << " (exp " << expected << ") - "
              << (pass ? "PASS" : "FAIL") << "\n";
@@ -97,7 +114,7 @@ SC_MODULE(ComprehensiveTestbench) {
     }
 
     void check_excs(const string& phase) {
-        sc_uint<8> flags = fpu_top->decode_stage->get_exception_flags();
+        sc_uint<8> flags = fpu_top->register_file->get_exception_flags();
         cout << "\n--- Exception Status (" << phase << ") ---\n";
         if (flags & FP_INVALID_OP)     cout << "⚠️  Invalid Operation\n";
         if (flags & FP_OVERFLOW)       cout << "⚠️  Overflow\n";
@@ -107,6 +124,94 @@ SC_MODULE(ComprehensiveTestbench) {
         if (flags == 0) cout << "✅ No exceptions\n";
     }
 
+    bool pipeline_idle() const {
+        return fpu_top->fetch_stage->pc >= fpu_top->fetch_stage->imem_size && !fpu_top->fetch_to_decode.read().valid &&
+               !fpu_top->decode_to_execute.read().valid && !fpu_top->execute_to_wb.read().valid &&
+               fpu_top->execute_div_busy.read() == 0;
+    }
+
+    // Runs the selected vectors in batches of ten independent instructions,
+    // vector k of a batch reading f(3k+1), f(3k+2) and writing f(3k+3), with
+    // no more FDIVs in a batch than divider slots. Writebacks are told apart
+    // by pc; a vector that never writes back fails as lost.
+    void run_vectors() {
+        static const int BATCH = 10;
+        const fpu_vector_t* v = db->vectors();
+        std::deque<uint32_t> queue(selection.begin(), selection.end());
+        uint64_t cycles = 0, unchecked = 0, lost = 0;
+        unsigned shown = 0;
+
+        while (!queue.empty()) {
+            uint32_t    batch[BATCH];
+            sc_uint<32> program[BATCH];
+            int n = 0, divs = 0;
+            std::vector<uint32_t> held;   // FDIVs beyond the divider slots, for the next batch
+            while (n < BATCH && !queue.empty() && held.size() < (size_t)BATCH) {
+                uint32_t i = queue.front();
+                queue.pop_front();
+                const fpu_vector_t& t = v[i];
+                if (t.opcode == OP_FDIV && divs == FPU_DIV_SLOTS) {
+                    held.push_back(i);
+                    continue;
+                }
+                divs += t.opcode == OP_FDIV;
+                batch[n] = i;
+                fpu_top->register_file->set_register_bits(3 * n + 1, t.a);
+                fpu_top->register_file->set_register_bits(3 * n + 2, t.b);
+                program[n] = fp_instruction_t(t.opcode, 3 * n + 3, 3 * n + 1, 3 * n + 2).to_word();
+                ++n;
+            }
+            queue.insert(queue.begin(), held.begin(), held.end());
+            fpu_top->fetch_stage->load_program(program, n);
+            fpu_top->fetch_stage->pc = 0;
+
+            bool            seen[BATCH] = {};
+            execute_to_wb_t wb[BATCH];
+            // Results stay out of sight for DEPTH cycles inside Execute
+            for (unsigned quiet = 0; quiet <= Execute::DEPTH;) {
+                wait(10, SC_NS);
+                ++cycles;
+                execute_to_wb_t w = fpu_top->execute_to_wb.read();
+                unsigned slot = w.pc.to_uint() / 4;
+                if (w.valid && slot < (unsigned)n && !seen[slot]) {
+                    seen[slot] = true;
+                    wb[slot]   = w;
+                }
+                quiet = pipeline_idle() ? quiet + 1 : 0;
+            }
+
+            for (int k = 0; k < n; ++k) {
+                const fpu_vector_t& t = v[batch[k]];
+                if (!seen[k]) ++lost;
+                sc_uint<32> reg  = fpu_top->register_file->read_register(3 * k + 3);
+                bool        pass = seen[k] && reg == wb[k].result;
+                if (!(t.flags & FPU_VECTOR_CHECK)) {
+                    if (pass) { ++unchecked; continue; }
+                } else {
+                    pass = pass && wb[k].result == t.expected && wb[k].exceptions == t.expected_exceptions;
+                }
+                if (pass) { tests_passed++; continue; }
+                tests_failed++;
+                if (shown++ >= show) continue;
+                cout << "vector " << batch[k] << ": " << fpu_vector_op_names[t.opcode & 3] << hex << setfill('0')
+                     << " a 0x" << setw(8) << t.a << " b 0x" << setw(8) << t.b << " expected 0x" << setw(8)
+                     << t.expected << "/" << setw(2) << (int)t.expected_exceptions;
+                if (seen[k])
+                    cout << " got 0x" << setw(8) << wb[k].result << "/" << setw(2) << wb[k].exceptions
+                         << " f" << dec << 3 * k + 3 << " = 0x" << hex << setw(8) << reg;
+                else
+                    cout << " never written back";
+                cout << dec << setfill(' ') << "\n";
+            }
+        }
+
+        cout << "\n=== VECTOR SUMMARY ===\n";
+        cout << "Vectors: " << selection.size() << "  Passed: " << tests_passed << "  Failed: " << tests_failed
+             << "  Unchecked: " << unchecked << "  Lost: " << lost << "\n";
+        cout << "Cycles: " << cycles << "  Vectors/cycle: "
+             << (cycles ? (double)selection.size() / cycles : 0.0) << "\n";
+    }
+
     void test_thread() {
         cout << "\n=== FPU PIPELINE (Synthesizable RTL + TB) ===\n";
 
@@ -117,13 +222,21 @@ SC_MODULE(ComprehensiveTestbench) {
         reset.write(false);
         wait(5, SC_NS);
 
+        if (db) {
+            run_vectors();
+            sc_stop();
+            return;
+        }
+
         setup_regs();
         create_program();
 
         cout << "Running...\n";
         int max_cycles = 140;
+        int last_writeback = -1;
         for (int c = 0; c < max_cycles; ++c) {
             wait(10, SC_NS);
+            if (fpu_top->execute_to_wb.read().valid) last_writeback = c;
 
             if (c == 40) {
                 cout << "\n--- Basic Ops @ cycle " << c << " ---\n";
@@ -136,7 +249,7 @@ SC_MODULE(ComprehensiveTestbench) {
                 cout << "\n--- Division & Exceptions @ cycle " << c << " ---\n";
                 check_result_f(6, 1.5f, "FDIV 3/2");
 
-                sc_uint<32> f7 = fpu_top->decode_stage->fp_registers[7];
+                sc_uint<32> f7 = fpu_top->register_file->read_register(7);
                 ieee754_components comp7 = decompose_ieee754_dbg(f7);
                 if (comp7.is_infinity && !comp7.sign) { cout << "FDIV by zero -> +inf : PASS\n"; tests_passed++; }
                 else { cout << "FDIV by zero wrong\n"; tests_failed++; }
@@ -144,17 +257,17 @@ SC_MODULE(ComprehensiveTestbench) {
             }
             if (c == 100) {
                 cout << "\n--- Special Cases @ cycle " << c << " ---\n";
-                sc_uint<32> f9  = fpu_top->decode_stage->fp_registers[9];
+                sc_uint<32> f9  = fpu_top->register_file->read_register(9);
                 ieee754_components c9 = decompose_ieee754_dbg(f9);
                 if (c9.is_nan) { cout << "inf + (-inf) -> NaN : PASS\n"; tests_passed++; }
                 else { cout << "inf + (-inf) failed\n"; tests_failed++; }
 
-                sc_uint<32> f12 = fpu_top->decode_stage->fp_registers[12];
+                sc_uint<32> f12 = fpu_top->register_file->read_register(12);
                 ieee754_components c12 = decompose_ieee754_dbg(f12);
                 if (c12.is_zero || c12.is_denormalized) { cout << "Underflow MUL tiny*tiny : PASS\n"; tests_passed++; }
                 else { cout << "Underflow test failed\n"; tests_failed++; }
 
-                sc_uint<32> f15 = fpu_top->decode_stage->fp_registers[15];
+                sc_uint<32> f15 = fpu_top->register_file->read_register(15);
                 ieee754_components c15 = decompose_ieee754_dbg(f15);
                 if (c15.is_infinity) { cout << "Overflow MUL large*large : PASS\n"; tests_passed++; }
                 else { cout << "Overflow test failed\n"; tests_failed++; }
@@ -163,12 +276,12 @@ SC_MODULE(ComprehensiveTestbench) {
             }
             if (c == 120) {
                 cout << "\n--- Denorm tests @ cycle " << c << " ---\n";
-                sc_uint<32> f18 = fpu_top->decode_stage->fp_registers[18];
+                sc_uint<32> f18 = fpu_top->register_file->read_register(18);
                 ieee754_components c18 = decompose_ieee754_dbg(f18);
                 cout << "Denorm ADD f18 = " << ieee754_bits_to_float(f18)
                      << " (" << (c18.is_denormalized ? "denorm" : (c18.is_zero ? "zero" : "normal")) << ")\n";
 
-                sc_uint<32> f21 = fpu_top->decode_stage->fp_registers[21];
+                sc_uint<32> f21 = fpu_top->register_file->read_register(21);
                 ieee754_components c21 = decompose_ieee754_dbg(f21);
                 cout << "Denorm MUL f21 = " << ieee754_bits_to_float(f21)
                      << " (" << (c21.is_denormalized ? "denorm" : (c21.is_zero ? "zero" : "normal")) << ")\n";
@@ -177,8 +290,11 @@ SC_MODULE(ComprehensiveTestbench) {
             }
         }
 
+        fpu_top->dump_perf_counters(cout);
+
         cout << "\n=== FINAL SUMMARY ===\n";
         cout << "Passed: " << tests_passed << "  Failed: " << tests_failed << "\n";
+        cout << "Execute depth: " << Execute::DEPTH << "  Last writeback at cycle: " << last_writeback << "\n";
         sc_stop();
     }
 
@@ -201,9 +317,41 @@ SC_MODULE(ComprehensiveTestbench) {
 
 // ---------------- MAIN (TB only) ----------------
 int sc_main(int argc, char* argv[]) {
+    std::string vectors, select;
+    unsigned    show = 10;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        bool has_val = i + 1 < argc;
+        if (a == "--vectors" && has_val) vectors = argv[++i];
+        else if (a == "--select" && has_val) select = argv[++i];
+        else if (a == "--show" && has_val) show = (unsigned)std::strtoul(argv[++i], nullptr, 0);
+        else {
+            cerr << "usage: " << argv[0] << " [--vectors FILE [--select OP:A:B] [--show N]]\n";
+            return 1;
+        }
+    }
+
     cout << "=== FPU PIPELINE (Synth-Ready RTL + TB) ===\n";
     ComprehensiveTestbench tb("tb");
+
+    fpu_vector_map db;
+    if (!vectors.empty()) {
+        std::string error;
+        int op = -1, class_a = -1, class_b = -1;
+        if (!fpu_vector_parse_select(select, op, class_a, class_b)) {
+            cerr << "bad --select " << select << " (OP:A:B, e.g. fdiv:nan:*)\n";
+            return 1;
+        }
+        if (!db.open_vectors(vectors, error)) {
+            cerr << error << "\n";
+            return 1;
+        }
+        tb.db        = &db;
+        tb.selection = db.select(op, class_a, class_b);
+        tb.show      = show;
+    }
+
     sc_start();
     cout << "\nSimulation done.\n";
-    return 0;
+    return tb.db && tb.tests_failed ? 1 : 0;
 }
@@ -0,0 +1,131 @@
+#ifndef VECTOR_DRIVER_H
+#define VECTOR_DRIVER_H
+
+// Streams an FpuVectorFile.h vector file through Execute, one operation per
+// cycle, writes each result into the mapped result file and stops the
+// simulation once every vector has one. Stands in for Fetch, Decode and the
+// register file: there is no program to load and no register seeding, so a
+// run costs about one clock per vector.
+//
+// The vector index travels as the pc, so results are matched however they
+// come back. Execute discards an FDIV that finds every divider slot taken;
+// the driver avoids that by holding FDIVs while FPU_DIV_SLOTS divisions are
+// outstanding, deferring them behind the operations that follow.
+
+#include <deque>
+#include "PipelinedFPUUnitsProcessor.h"
+#include "FpuVectorFile.h"
+
+SC_MODULE(VectorDriver) {
+    sc_in<bool> clk;
+    sc_in<bool> reset;
+
+    sc_out<decode_to_execute_t> out;      // Execute::in
+    sc_in<execute_to_wb_t>      in;       // Execute::out
+    sc_in<bool>                 div_dropped_in;
+
+    const fpu_vector_t*  vectors;
+    fpu_vector_result_t* results;
+    uint64_t             count;
+
+    // Totals for the report
+    uint64_t passed, failed, unchecked, cycles;
+
+    void bind(const fpu_vector_t* v, fpu_vector_result_t* r, uint64_t n) {
+        vectors = v;
+        results = r;
+        count   = n;
+    }
+
+    bool done() const { return completed == count; }
+
+    void drive() {
+        if (reset.read()) {
+            out.write(decode_to_execute_t());
+            return;
+        }
+        ++cycles;
+        collect();
+
+        decode_to_execute_t d = out.read();
+        uint64_t idx;
+        d.valid = next_issue(idx);
+        if (d.valid) {
+            const fpu_vector_t& v = vectors[idx];
+            d.pc       = (uint32_t)idx;
+            d.opcode   = v.opcode;
+            d.rd       = 0;
+            d.operand1 = v.a;
+            d.operand2 = v.b;
+            if (v.opcode == OP_FDIV) ++divs_outstanding;
+            ++outstanding;
+        }
+        out.write(d);
+
+        // Everything issued has come back; a vector still not_run was dropped
+        if (!d.valid && outstanding == 0 && pos == count && deferred.empty()) sc_stop();
+    }
+
+    SC_CTOR(VectorDriver)
+        : vectors(nullptr), results(nullptr), count(0), passed(0), failed(0), unchecked(0), cycles(0), pos(0),
+          completed(0), outstanding(0), divs_outstanding(0) {
+        SC_METHOD(drive);
+        sensitive << clk.pos();
+    }
+
+private:
+    enum { OP_FDIV = 0x3 };
+
+    uint64_t             pos;                // next vector not yet issued
+    uint64_t             completed;
+    uint64_t             outstanding;        // issued, neither back nor dropped
+    unsigned             divs_outstanding;
+    std::deque<uint64_t> deferred;           // held FDIVs
+
+    void collect() {
+        outstanding -= div_dropped_in.read();
+        divs_outstanding -= div_dropped_in.read();
+        const execute_to_wb_t& o = in.read();
+        if (!o.valid) return;
+        --outstanding;
+        if (o.opcode == OP_FDIV) --divs_outstanding;
+
+        uint64_t idx = o.pc.to_uint();
+        if (idx >= count || results[idx].status != FPU_VECTOR_NOT_RUN) return;
+        const fpu_vector_t&  v = vectors[idx];
+        fpu_vector_result_t& r = results[idx];
+        r.result     = o.result.to_uint();
+        r.exceptions = (uint8_t)o.exceptions.to_uint();
+        if (!(v.flags & FPU_VECTOR_CHECK)) {
+            r.status = FPU_VECTOR_DONE;
+            ++unchecked;
+        } else if (r.result == v.expected && r.exceptions == v.expected_exceptions) {
+            r.status = FPU_VECTOR_PASS;
+            ++passed;
+        } else {
+            r.status = FPU_VECTOR_FAIL;
+            ++failed;
+        }
+        ++completed;
+    }
+
+    bool div_slot_free() const { return divs_outstanding < (unsigned)FPU_DIV_SLOTS; }
+
+    // Deferred vectors first, as soon as they can go; then the stream, with
+    // FDIVs that would find no divider slot set aside
+    bool next_issue(uint64_t& idx) {
+        if (!deferred.empty() && (vectors[deferred.front()].opcode != OP_FDIV || div_slot_free())) {
+            idx = deferred.front();
+            deferred.pop_front();
+            return true;
+        }
+        while (pos < count) {
+            idx = pos++;
+            if (vectors[idx].opcode != OP_FDIV || div_slot_free()) return true;
+            deferred.push_back(idx);
+        }
+        return false;
+    }
+};
+
+#endif // VECTOR_DRIVER_H
@@ -0,0 +1,198 @@
+#ifndef FPU_BENCH_COMMON_H
+#define FPU_BENCH_COMMON_H
+
+// Shared helpers for the simulation-throughput benchmarks: instruction
+// mixes, program/register generation, timing, peak RSS and JSON output.
+
+#include <sys/resource.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+// Abstract FP instruction; each benchmark encodes it for its own core
+struct bench_inst_t {
+    unsigned op;   // 0 = add, 1 = sub, 2 = mul, 3 = div
+    unsigned rd, rs1, rs2;
+};
+
+// RV32F encoding of the non-pipelined core and FPU.sv, shared by every tool
+// that writes their images. OP-FP: funct7 = op << 2
+// (fadd.s/fsub.s/fmul.s/fdiv.s), rm = 0
+static inline uint32_t encode_rv32f(const bench_inst_t& i) {
+    return ((i.op << 2) << 25) | (i.rs2 << 20) | (i.rs1 << 15) | (i.rd << 7) | 0x53;
+}
+
+struct bench_mix_t {
+    const char* name;
+    unsigned    weight[4];        // add, sub, mul, div
+    bool        special_operands; // seed sources with zero/inf/NaN/denorm
+};
+
+static const bench_mix_t bench_mixes[] = {
+    {"add-only", {1, 0, 0, 0}, false},
+    {"mul-only", {0, 0, 1, 0}, false},
+    {"div-heavy", {1, 1, 1, 3}, false},
+    {"mixed", {1, 1, 1, 1}, false},
+    {"special", {1, 1, 1, 1}, true},
+};
+
+static inline const bench_mix_t* find_bench_mix(const std::string& name) {
+    for (const bench_mix_t& m : bench_mixes)
+        if (name == m.name) return &m;
+    return nullptr;
+}
+
+// Small deterministic generator so runs are comparable across commits
+struct bench_rng {
+    uint32_t state;
+    explicit bench_rng(uint32_t seed) : state(seed ? seed : 1) {}
+    uint32_t next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+};
+
+// Sources live in f1..f15 and destinations in f16..f31, so operand values
+// stay fixed for the whole run and every iteration does the same work.
+static inline std::vector<bench_inst_t> make_bench_program(const bench_mix_t& mix, int count, uint32_t seed) {
+    bench_rng rng(seed);
+    unsigned total = mix.weight[0] + mix.weight[1] + mix.weight[2] + mix.weight[3];
+    std::vector<bench_inst_t> prog;
+    for (int i = 0; i < count; ++i) {
+        unsigned pick = rng.next() % total, op = 0;
+        while (pick >= mix.weight[op]) pick -= mix.weight[op++];
+        bench_inst_t inst;
+        inst.op  = op;
+        inst.rd  = 16 + rng.next() % 16;
+        inst.rs1 = 1 + rng.next() % 15;
+        inst.rs2 = 1 + rng.next() % 15;
+        prog.push_back(inst);
+    }
+    return prog;
+}
+
+static inline void bench_seed_registers(const bench_mix_t& mix, uint32_t regs[32]) {
+    static const uint32_t normal[15] = {
+        0x40490FD0, 0x402DF84D, 0x3F800000, 0xBFC00000, 0x41200000,
+        0x3EAAAAAB, 0xC0E00000, 0x42F6E979, 0x3A83126F, 0xC2C80000,
+        0x3F000000, 0x40000000, 0x4479C000, 0xBE4CCCCD, 0x461C4000};
+    static const uint32_t special[15] = {
+        0x00000000, 0x80000000, 0x7F800000, 0xFF800000, 0x7FC00000,
+        0x00400000, 0x00000001, 0x00800000, 0x7F7FFFFF, 0x7F000000,
+        0x3F800000, 0xBF800000, 0x00200000, 0x40490FD0, 0x807FFFFF};
+    for (int i = 0; i < 32; ++i) regs[i] = 0;
+    for (int i = 0; i < 15; ++i) regs[i + 1] = mix.special_operands ? special[i] : normal[i];
+}
+
+struct bench_options {
+    std::string mix     = "mixed";
+    uint64_t    cycles  = 2000000;
+    uint32_t    seed    = 1;
+    std::string json;          // empty: print JSON to stdout
+    std::string trace;         // instruction lifecycle trace file (pipelined only)
+    std::string kanata;        // Kanata pipeline log (pipelined only)
+    std::string commit_log;    // Spike-format commit log
+    std::string save_ckpt;     // checkpoint written after the run (pipelined only)
+    std::string load_ckpt;     // checkpoint the run resumes from (pipelined only)
+    bool        verbose = false;
+};
+
+static inline void bench_usage(const char* prog) {
+    std::cerr << "usage: " << prog << " [--mix NAME] [--cycles N] [--seed N] [--json FILE] [--trace FILE] [--kanata FILE]\n"
+              << "       [--commit-log FILE] [--save-checkpoint FILE] [--load-checkpoint FILE] [--verbose]\n"
+              << "mixes:";
+    for (const bench_mix_t& m : bench_mixes) std::cerr << " " << m.name;
+    std::cerr << "\n";
+}
+
+static inline bool parse_bench_args(int argc, char* argv[], bench_options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        bool has_val = i + 1 < argc;
+        if (a == "--mix" && has_val) opt.mix = argv[++i];
+        else if (a == "--cycles" && has_val) opt.cycles = std::strtoull(argv[++i], nullptr, 0);
+        else if (a == "--seed" && has_val) opt.seed = (uint32_t)std::strtoul(argv[++i], nullptr, 0);
+        else if (a == "--json" && has_val) opt.json = argv[++i];
+        else if (a == "--trace" && has_val) opt.trace = argv[++i];
+        else if (a == "--kanata" && has_val) opt.kanata = argv[++i];
+        else if (a == "--commit-log" && has_val) opt.commit_log = argv[++i];
+        else if (a == "--save-checkpoint" && has_val) opt.save_ckpt = argv[++i];
+        else if (a == "--load-checkpoint" && has_val) opt.load_ckpt = argv[++i];
+        else if (a == "--verbose") opt.verbose = true;
+        else { bench_usage(argv[0]); return false; }
+    }
+    if (!find_bench_mix(opt.mix)) { bench_usage(argv[0]); return false; }
+    return true;
+}
+
+struct bench_result_t {
+    std::string model;
+    std::string mix;
+    uint32_t    seed           = 0;
+    int         program_length = 0;
+    uint64_t    cycles         = 0;
+    uint64_t    retired        = 0;
+    uint64_t    delta_cycles   = 0;
+    double      wall_seconds   = 0;
+    long        peak_rss_kb    = 0;
+    int64_t     operand_toggles = -1;  // functional-unit input bit flips; -1: not measured
+};
+
+static inline long bench_peak_rss_kb() {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_maxrss; // kilobytes on Linux
+}
+
+// Cycles for everything in flight to retire once fetching stops, on either
+// core. On the pipelined core the last FDIV is the worst case: up to 2 + 4
+// Execute stages with every FPU_EXEC_SPLITS bit set, its 24 steps in a
+// divider slot, then up to FPU_DIV_SLOTS (4) finished divisions taking the
+// result port one cycle each, about 34 in all. The non-pipelined core at
+// -DFPU_DIV_ITERS_PER_STAGE=1 needs its 25 divider stages and five more.
+static const int DRAIN_CYCLES = 64;
+
+class bench_timer {
+    std::chrono::steady_clock::time_point t0;
+public:
+    bench_timer() : t0(std::chrono::steady_clock::now()) {}
+    double seconds() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    }
+};
+
+// Swallows model console output so the benchmark measures simulation, not the terminal
+class bench_null_buf : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+static inline void write_bench_json(std::ostream& os, const bench_result_t& r) {
+    double secs = r.wall_seconds > 0 ? r.wall_seconds : 1e-9;
+    os << std::dec; // the models leave std::hex set on cout
+    os << "{\"model\": \"" << r.model << "\""
+       << ", \"mix\": \"" << r.mix << "\""
+       << ", \"seed\": " << r.seed
+       << ", \"program_length\": " << r.program_length
+       << ", \"cycles\": " << r.cycles
+       << ", \"retired\": " << r.retired
+       << ", \"ipc\": " << (r.cycles ? (double)r.retired / r.cycles : 0.0)
+       << ", \"delta_cycles\": " << r.delta_cycles
+       << ", \"deltas_per_cycle\": " << (r.cycles ? (double)r.delta_cycles / r.cycles : 0.0)
+       << ", \"wall_seconds\": " << r.wall_seconds
+       << ", \"cycles_per_second\": " << r.cycles / secs
+       << ", \"instructions_per_second\": " << r.retired / secs
+       << ", \"peak_rss_kb\": " << r.peak_rss_kb;
+    if (r.operand_toggles >= 0) os << ", \"operand_toggles\": " << r.operand_toggles;
+    os << "}\n";
+}
+
+#endif // FPU_BENCH_COMMON_H
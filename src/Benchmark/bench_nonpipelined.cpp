@@ -0,0 +1,111 @@
+// Simulation-throughput benchmark for the non-pipelined FPPipelinedProcessor.
+// All instruction memory words hold non-zero instructions, so the IFU
+// never sees the terminating zero and the PC wraps around the memory.
+
+#include <systemc.h>
+#include "processor.h"
+#include "bench_common.h"
+#include <fstream>
+
+// Counts register-file writes on the falling edge
+SC_MODULE(ProcessorBenchDriver) {
+    sc_in<bool> clk;
+
+    FPPipelinedProcessor* system;
+    uint64_t retired;
+
+    void monitor() {
+        if (system->wb_valid_out.read() && system->wb_reg_write_en.read()) ++retired;
+    }
+
+    SC_CTOR(ProcessorBenchDriver) : system(nullptr), retired(0) {
+        SC_METHOD(monitor);
+        sensitive << clk.neg();
+        dont_initialize();
+    }
+};
+
+int sc_main(int argc, char* argv[]) {
+    bench_options opt;
+    if (!parse_bench_args(argc, argv, opt)) return 1;
+    if (!opt.trace.empty() || !opt.kanata.empty() || !opt.save_ckpt.empty() || !opt.load_ckpt.empty()) {
+        std::cerr << "tracing and checkpoints are only supported by the pipelined model\n";
+        return 1;
+    }
+    const bench_mix_t& mix = *find_bench_mix(opt.mix);
+
+    sc_clock clock("clk", 10, SC_NS);
+    sc_signal<bool> reset;
+    sc_signal<bool> stall_signal;
+    sc_signal<bool> monitor_valid;
+    sc_signal<sc_uint<8>> monitor_pc;
+
+    FPPipelinedProcessor system("system");
+    system.clk(clock);
+    system.reset(reset);
+    system.stall(stall_signal);
+    system.monitor_valid(monitor_valid);
+    system.monitor_pc(monitor_pc);
+
+    ProcessorBenchDriver driver("driver");
+    driver.clk(clock);
+    driver.system = &system;
+
+    std::vector<bench_inst_t> prog = make_bench_program(mix, InstructionMemory::DEPTH, opt.seed);
+    std::vector<uint32_t> words;
+    for (const bench_inst_t& i : prog) words.push_back(encode_rv32f(i));
+    system.imem.load(words.data(), words.size());
+
+    uint32_t regs[32];
+    bench_seed_registers(mix, regs);
+    for (int r = 0; r < 32; ++r) system.reg_file[r].write(regs[r]);
+
+    if (!opt.commit_log.empty() && !CommitLog::start(opt.commit_log.c_str())) {
+        std::cerr << "cannot open commit log " << opt.commit_log << "\n";
+        return 1;
+    }
+
+    bench_null_buf null_buf;
+    std::streambuf* saved = nullptr;
+    if (!opt.verbose) saved = cout.rdbuf(&null_buf);
+    if (opt.verbose) SimLog::start(stdout);
+
+    reset.write(true);
+    stall_signal.write(false);
+    sc_start(15, SC_NS);
+    reset.write(false);
+
+    uint64_t deltas0 = sc_delta_count();
+#ifdef FPU_COUNT_TOGGLES
+    uint64_t toggles0 = system.execute.operand_toggles;
+#endif
+    bench_timer timer;
+    sc_start(sc_time(10.0 * opt.cycles, SC_NS));
+    double secs = timer.seconds();
+
+    CommitLog::stop();
+    SimLog::stop();
+    if (saved) cout.rdbuf(saved);
+
+    bench_result_t r;
+    r.model          = "nonpipelined";
+    r.mix            = mix.name;
+    r.seed           = opt.seed;
+    r.program_length = (int)prog.size();
+    r.cycles         = opt.cycles;
+    r.retired        = driver.retired;
+    r.delta_cycles   = sc_delta_count() - deltas0;
+    r.wall_seconds   = secs;
+    r.peak_rss_kb    = bench_peak_rss_kb();
+#ifdef FPU_COUNT_TOGGLES
+    r.operand_toggles = (int64_t)(system.execute.operand_toggles - toggles0);
+#endif
+
+    if (opt.json.empty()) {
+        write_bench_json(cout, r);
+    } else {
+        std::ofstream out(opt.json.c_str(), std::ios::app);
+        write_bench_json(out, r);
+    }
+    return 0;
+}
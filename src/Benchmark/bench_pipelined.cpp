@@ -0,0 +1,127 @@
+// Simulation-throughput benchmark for FPU_Pipeline_Top.
+// Loads a 256-instruction program for the selected mix and keeps
+// re-fetching it until the requested number of cycles has been simulated.
+
+#include "PipelinedFPUUnitsProcessor.h"
+#include "bench_common.h"
+#include <fstream>
+
+// Counts retirements and wraps the fetch PC; runs on the falling edge so it
+// never races the stage processes on the rising edge.
+SC_MODULE(PipelineBenchDriver) {
+    sc_in<bool> clk;
+
+    FPU_Pipeline_Top* fpu;
+    uint64_t retired;
+
+    void monitor() {
+        if (fpu->execute_to_wb.read().valid) ++retired;
+        if (fpu->fetch_stage->pc >= fpu->fetch_stage->imem_size) fpu->fetch_stage->pc = 0;
+    }
+
+    SC_CTOR(PipelineBenchDriver) : fpu(nullptr), retired(0) {
+        SC_METHOD(monitor);
+        sensitive << clk.neg();
+        dont_initialize();
+    }
+};
+
+int sc_main(int argc, char* argv[]) {
+    bench_options opt;
+    if (!parse_bench_args(argc, argv, opt)) return 1;
+    const bench_mix_t& mix = *find_bench_mix(opt.mix);
+
+    sc_clock clk("clk", 10, SC_NS);
+    sc_signal<bool> reset;
+    sc_signal<bool> stall;
+
+    FPU_Pipeline_Top fpu("fpu_pipeline");
+    fpu.clk(clk);
+    fpu.reset(reset);
+    fpu.stall(stall);
+
+    PipelineBenchDriver driver("driver");
+    driver.clk(clk);
+    driver.fpu = &fpu;
+
+    reset.write(true);
+    stall.write(false);
+    sc_start(25, SC_NS);
+    reset.write(false);
+
+    std::vector<bench_inst_t> prog = make_bench_program(mix, 256, opt.seed);
+    std::vector<sc_uint<32>> words;
+    for (const bench_inst_t& i : prog)
+        words.push_back(fp_instruction_t(i.op, i.rd, i.rs1, i.rs2).to_word());
+    fpu.fetch_stage->load_program(words.data(), (int)words.size());
+
+    uint32_t regs[32];
+    bench_seed_registers(mix, regs);
+    for (int r = 1; r < 32; ++r) fpu.register_file->set_register_bits(r, regs[r]);
+
+    // A checkpoint replaces the freshly loaded program, registers and pipeline
+    std::string error;
+    if (!opt.load_ckpt.empty() && !fpu.load_checkpoint(opt.load_ckpt, &error)) {
+        std::cerr << opt.load_ckpt << ": " << error << "\n";
+        return 1;
+    }
+
+    bench_null_buf null_buf;
+    std::streambuf* saved = nullptr;
+    if (!opt.verbose) saved = cout.rdbuf(&null_buf);
+
+#ifndef FPU_NO_INST_TRACE
+    if (!opt.trace.empty() && !InstTracer::start(opt.trace.c_str(), clk.period().value())) {
+        std::cerr << "cannot open trace file " << opt.trace << "\n";
+        return 1;
+    }
+    if (!opt.kanata.empty() && !KanataLog::start(opt.kanata.c_str(), clk.period().value())) {
+        std::cerr << "cannot open Kanata log " << opt.kanata << "\n";
+        return 1;
+    }
+    if (!opt.commit_log.empty()) {
+        if (!CommitLog::start(opt.commit_log.c_str())) {
+            std::cerr << "cannot open commit log " << opt.commit_log << "\n";
+            return 1;
+        }
+        CommitLog::active()->set_insn_lookup(
+            [&fpu](uint32_t pc) { return fpu.fetch_stage->imem[(pc / 4) % 256].to_uint(); });
+    }
+#endif
+
+    uint64_t deltas0 = sc_delta_count();
+    bench_timer timer;
+    sc_start(sc_time(10.0 * opt.cycles, SC_NS));
+#ifndef FPU_NO_INST_TRACE
+    InstTracer::stop(); // the drain counts towards the traced run time
+    KanataLog::stop();
+    CommitLog::stop();
+#endif
+    double secs = timer.seconds();
+
+    if (saved) cout.rdbuf(saved);
+
+    if (!opt.save_ckpt.empty() && !fpu.save_checkpoint(opt.save_ckpt)) {
+        std::cerr << "cannot write checkpoint " << opt.save_ckpt << "\n";
+        return 1;
+    }
+
+    bench_result_t r;
+    r.model          = "pipelined";
+    r.mix            = mix.name;
+    r.seed           = opt.seed;
+    r.program_length = (int)prog.size();
+    r.cycles         = opt.cycles;
+    r.retired        = driver.retired;
+    r.delta_cycles   = sc_delta_count() - deltas0;
+    r.wall_seconds   = secs;
+    r.peak_rss_kb    = bench_peak_rss_kb();
+
+    if (opt.json.empty()) {
+        write_bench_json(cout, r);
+    } else {
+        std::ofstream out(opt.json.c_str(), std::ios::app);
+        write_bench_json(out, r);
+    }
+    return 0;
+}
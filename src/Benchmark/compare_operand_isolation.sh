@@ -0,0 +1,51 @@
+#!/bin/sh
+# Builds bench_nonpipelined.cpp with and without operand isolation
+# (FPU_NO_OPERAND_ISOLATION, see execute.h in the non-pipelined core) and
+# reports, per mix, the simulation speedup and the reduction in bit flips
+# on the functional units' operand inputs:
+#   compare_operand_isolation.sh [cycles] [mixes...]   (default: 200000, all)
+# Needs SYSTEMC_HOME; CXX defaults to c++.
+set -e
+
+: "${SYSTEMC_HOME:?SYSTEMC_HOME must point to a SystemC installation}"
+CXX=${CXX:-c++}
+ROOT=$(cd "$(dirname "$0")/../.." && pwd)
+CYCLES=${1:-200000}
+[ $# -gt 0 ] && shift
+MIXES=${*:-"add-only mul-only div-heavy mixed special"}
+
+SCLIB=$SYSTEMC_HOME/lib
+[ -d "$SCLIB" ] || SCLIB=$SYSTEMC_HOME/lib-linux64
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+# Speed is timed without the toggle counter, which watches every unit input;
+# the flips come from a second build with -DFPU_COUNT_TOGGLES
+for v in shared isolated; do
+    flags=""
+    [ $v = shared ] && flags=-DFPU_NO_OPERAND_ISOLATION
+    for count in "" -DFPU_COUNT_TOGGLES; do
+        out=bench_$v
+        [ -n "$count" ] && out=flips_$v
+        "$CXX" -std=c++17 -O2 $flags $count -I"$SYSTEMC_HOME/include" -I"$ROOT/src/System C/FPU units Non pipelined" \
+            "$ROOT/src/Benchmark/bench_nonpipelined.cpp" -L"$SCLIB" -Wl,-rpath,"$SCLIB" -lsystemc -lpthread \
+            -o "$WORK/$out"
+    done
+done
+
+field() { sed -n "s/.*\"$1\": \([0-9.e+-]*\).*/\1/p" "$2"; }
+
+printf '%-10s %10s %10s %8s %14s %14s %9s\n' mix shared_s isolated_s speedup shared_flips isolated_flips reduction
+for mix in $MIXES; do
+    for v in shared isolated; do
+        "$WORK/bench_$v" --mix "$mix" --cycles "$CYCLES" > "$WORK/$v.json"
+        "$WORK/flips_$v" --mix "$mix" --cycles "$CYCLES" > "$WORK/${v}_flips.json"
+    done
+    ws=$(field wall_seconds "$WORK/shared.json")
+    wi=$(field wall_seconds "$WORK/isolated.json")
+    ts=$(field operand_toggles "$WORK/shared_flips.json")
+    ti=$(field operand_toggles "$WORK/isolated_flips.json")
+    awk -v m="$mix" -v ws="$ws" -v wi="$wi" -v ts="$ts" -v ti="$ti" 'BEGIN {
+        printf "%-10s %10.3f %10.3f %7.2fx %14d %14d %8.1f%%\n", m, ws, wi, ws / wi, ts, ti, ts ? 100 * (ts - ti) / ts : 0
+    }'
+done
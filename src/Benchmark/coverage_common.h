@@ -0,0 +1,142 @@
+#ifndef FPU_COVERAGE_COMMON_H
+#define FPU_COVERAGE_COMMON_H
+
+// Shared driver for the coverage runners (coverage_pipelined.cpp,
+// coverage_nonpipelined.cpp): options, the batch loop that runs until the
+// crosses saturate, scenario emission and the JSON summary. Each runner
+// supplies how one batch is simulated on its core.
+
+#include "fp_coverage.h"
+#include "farm.h"
+#include <sys/stat.h>
+
+struct coverage_options {
+    uint32_t         seed        = 1;
+    int              batch       = 256;     // instructions per program, at most 256
+    int              saturate    = 50;      // batches without a new bin before stopping
+    uint64_t         max_batches = 100000;
+    bool             steer       = true;
+    bool             holes       = false;
+    bool             verbose     = false;
+    std::string      emit;
+    fp_stream_config gen;
+};
+
+static inline void coverage_usage(const char* prog) {
+    std::cerr << "usage: " << prog << " [--seed N] [--batch N] [--saturate N] [--max-batches N]\n"
+              << "       [--weights ADD,SUB,MUL,DIV] [--classes Z,DN,TINY,N,HUGE,INF,NAN]\n"
+              << "       [--dep-percent P] [--dep-max K] [--no-steer] [--holes] [--emit DIR] [--verbose]\n";
+}
+
+static inline bool parse_weights(const char* s, unsigned* w, int n) {
+    for (int i = 0; i < n; ++i) {
+        char* end;
+        w[i] = (unsigned)std::strtoul(s, &end, 0);
+        if (end == s || (i + 1 < n && *end != ',') || (i + 1 == n && *end)) return false;
+        s = end + 1;
+    }
+    return true;
+}
+
+static inline bool parse_coverage_args(int argc, char* argv[], coverage_options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        bool has_val = i + 1 < argc;
+        if (a == "--seed" && has_val) opt.seed = (uint32_t)std::strtoul(argv[++i], nullptr, 0);
+        else if (a == "--batch" && has_val) opt.batch = std::atoi(argv[++i]);
+        else if (a == "--saturate" && has_val) opt.saturate = std::atoi(argv[++i]);
+        else if (a == "--max-batches" && has_val) opt.max_batches = std::strtoull(argv[++i], nullptr, 0);
+        else if (a == "--weights" && has_val && parse_weights(argv[i + 1], opt.gen.op_weight, 4)) ++i;
+        else if (a == "--classes" && has_val && parse_weights(argv[i + 1], opt.gen.class_weight, FPC_NUM)) ++i;
+        else if (a == "--dep-percent" && has_val) opt.gen.dep_percent = (unsigned)std::atoi(argv[++i]);
+        else if (a == "--dep-max" && has_val) opt.gen.dep_max = (unsigned)std::atoi(argv[++i]);
+        else if (a == "--no-steer") opt.steer = false;
+        else if (a == "--holes") opt.holes = true;
+        else if (a == "--emit" && has_val) opt.emit = argv[++i];
+        else if (a == "--verbose") opt.verbose = true;
+        else { coverage_usage(argv[0]); return false; }
+    }
+    if (opt.batch < 1 || opt.batch > 256 || opt.saturate < 1) {
+        coverage_usage(argv[0]);
+        return false;
+    }
+    return true;
+}
+
+// Writes one contributing batch as DIR/SUB/covNNNNNN.img and appends it to
+// that directory's manifest
+static inline bool coverage_emit_image(const std::string& dir, const char* sub, uint64_t n, const uint32_t regs[32],
+                                       const std::vector<uint32_t>& words, uint64_t cycles) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "cov%06llu", (unsigned long long)n);
+    std::string path = dir + "/" + sub;
+    mkdir(dir.c_str(), 0777);
+    mkdir(path.c_str(), 0777);
+    bool ok = farm_write_image(path + "/" + name + ".img", regs, words);
+    std::ofstream m((path + "/manifest.txt").c_str(), std::ios::app);
+    m << "name=" << name << " image=" << name << ".img cycles=" << cycles << "\n";
+    return ok && m.good();
+}
+
+struct coverage_summary_t {
+    uint64_t batches         = 0;
+    uint64_t emitted         = 0;
+    uint64_t vectors         = 0;
+    uint64_t closing_batch   = 0;
+    uint64_t closing_vectors = 0;
+    uint64_t closing_cycles  = 0;
+    bool     saturated       = false;
+    double   wall_seconds    = 0;
+};
+
+// Runs batches until opt.saturate in a row add no bin. run(regs, prog)
+// simulates one program and returns the bins it hit first; emit(n, regs,
+// prog) keeps a batch that did. cycles is the runner's running clock count.
+// False if a scenario could not be written.
+template <class Run, class Emit>
+static bool coverage_run(const coverage_options& opt, fp_coverage& cov, const uint64_t& cycles, Run run, Emit emit,
+                         coverage_summary_t& s) {
+    fp_stream_gen gen(opt.gen, opt.seed);
+    bench_timer timer;
+    int idle = 0;
+    while (idle < opt.saturate && s.batches < opt.max_batches) {
+        if (opt.steer) cov.steer(gen.config(), opt.gen);
+        uint32_t regs[32];
+        gen.seed_registers(regs);
+        std::vector<bench_inst_t> prog = gen.program(opt.batch);
+
+        int fresh = run(regs, prog);
+        ++s.batches;
+        s.vectors += prog.size();
+
+        if (fresh) {
+            idle = 0;
+            s.closing_batch   = s.batches;
+            s.closing_vectors = s.vectors;
+            s.closing_cycles  = cycles;
+            if (!opt.emit.empty() && !emit(s.emitted++, regs, prog)) return false;
+            if (opt.verbose)
+                std::cerr << "batch " << s.batches << ": +" << fresh << " bins, " << cov.total_covered() << " / "
+                          << cov.total_bins() << "\n";
+        } else {
+            ++idle;
+        }
+    }
+    s.saturated    = idle >= opt.saturate;
+    s.wall_seconds = timer.seconds();
+    return true;
+}
+
+static inline void write_coverage_json(std::ostream& os, const char* model, const coverage_options& opt,
+                                       const fp_coverage& cov, uint64_t cycles, const coverage_summary_t& s) {
+    os << std::dec;
+    os << "{\"model\": \"" << model << "\", \"seed\": " << opt.seed << ", \"batches\": " << s.batches
+       << ", \"vectors\": " << s.vectors << ", \"cycles\": " << cycles
+       << ", \"retired\": " << cov.sample_count() << ", \"bins\": " << cov.total_bins()
+       << ", \"covered\": " << cov.total_covered() << ", \"saturated\": " << (s.saturated ? "true" : "false")
+       << ", \"closing_batch\": " << s.closing_batch << ", \"closing_vectors\": " << s.closing_vectors
+       << ", \"closing_cycles\": " << s.closing_cycles << ", \"emitted\": " << s.emitted
+       << ", \"wall_seconds\": " << s.wall_seconds << "}\n";
+}
+
+#endif // FPU_COVERAGE_COMMON_H
@@ -0,0 +1,113 @@
+// Coverage-driven constrained-random regression for the non-pipelined
+// FPPipelinedProcessor, the counterpart of coverage_pipelined.cpp. Each
+// batch is loaded as RV32F, the core is reset onto it, and every
+// write-back is sampled into the same crosses (fp_coverage.h).
+//
+//   fpu_coverage_nonpipelined --seed 7 --weights 1,1,1,2 --emit cov
+//
+// This core has no exception flags, so every retirement lands in the
+// "none" column of the flag cross; the operand cross is comparable with
+// the pipelined run. --emit DIR keeps contributing batches as DIR/rv32f
+// farm images.
+
+#include <systemc.h>
+#include "processor.h"
+#include "coverage_common.h"
+
+struct coverage_slot_t {
+    unsigned         op;
+    fp_operand_class a, b;
+};
+
+// Pairs the operands Decode hands to Execute with the write-back of the
+// same instruction, matched by fetch PC like the commit log
+SC_MODULE(NonPipelinedCoverageMonitor) {
+    sc_in<bool> clk;
+
+    FPPipelinedProcessor* system;
+    fp_coverage           cov;
+    coverage_slot_t       slots[InstructionMemory::DEPTH];
+    int                   fresh;      // new bins since last cleared
+    uint64_t              cycles;
+
+    void monitor() {
+        ++cycles;
+        if (system->decode_valid_out.read() && system->reg_write_out.read()) {
+            coverage_slot_t& s = slots[(system->decode_pc_out.read().to_uint() / 4) % InstructionMemory::DEPTH];
+            s.op = system->opcode.read().to_uint() >> 2;   // funct7 = op << 2
+            s.a  = classify_fp_operand(system->op1_out.read().to_uint());
+            s.b  = classify_fp_operand(system->op2_out.read().to_uint());
+        }
+        if (system->wb_valid_out.read() && system->wb_reg_write_en.read()) {
+            const coverage_slot_t& s = slots[(system->mem_pc_out.read().to_uint() / 4) % InstructionMemory::DEPTH];
+            fresh += cov.sample(s.op, s.a, s.b, 0);
+        }
+    }
+
+    SC_CTOR(NonPipelinedCoverageMonitor) : system(nullptr), fresh(0), cycles(0) {
+        SC_METHOD(monitor);
+        sensitive << clk.neg();
+        dont_initialize();
+    }
+};
+
+int sc_main(int argc, char* argv[]) {
+    coverage_options opt;
+    if (!parse_coverage_args(argc, argv, opt)) return 1;
+
+    sc_clock clock("clk", 10, SC_NS);
+    sc_signal<bool> reset;
+    sc_signal<bool> stall_signal;
+    sc_signal<bool> monitor_valid;
+    sc_signal<sc_uint<8>> monitor_pc;
+
+    FPPipelinedProcessor system("system");
+    system.clk(clock);
+    system.reset(reset);
+    system.stall(stall_signal);
+    system.monitor_valid(monitor_valid);
+    system.monitor_pc(monitor_pc);
+
+    NonPipelinedCoverageMonitor mon("coverage");
+    mon.clk(clock);
+    mon.system = &system;
+
+    stall_signal.write(false);
+
+    bench_null_buf null_buf;
+    std::streambuf* saved = cout.rdbuf(&null_buf);
+
+    // The IFU stops the simulation at a zero word, so the batch is repeated
+    // to fill the memory and the core is reset onto the next one instead;
+    // whatever it fetches past the batch while draining is sampled as well
+    auto run = [&](const uint32_t regs[32], const std::vector<bench_inst_t>& prog) {
+        std::vector<uint32_t> words;
+        for (unsigned i = 0; i < InstructionMemory::DEPTH; ++i) words.push_back(encode_rv32f(prog[i % prog.size()]));
+        reset.write(true);
+        sc_start(15, SC_NS);
+        system.imem.load(words.data(), words.size());
+        for (int r = 0; r < 32; ++r) system.reg_file[r].write(regs[r]);
+        reset.write(false);
+
+        mon.fresh = 0;
+        sc_start(sc_time(10.0 * (prog.size() + DRAIN_CYCLES), SC_NS));
+        return mon.fresh;
+    };
+    auto emit = [&](uint64_t n, const uint32_t regs[32], const std::vector<bench_inst_t>& prog) {
+        std::vector<uint32_t> words;
+        for (const bench_inst_t& i : prog) words.push_back(encode_rv32f(i));
+        return coverage_emit_image(opt.emit, "rv32f", n, regs, words, prog.size() + DRAIN_CYCLES);
+    };
+    coverage_summary_t sum;
+    bool ok = coverage_run(opt, mon.cov, mon.cycles, run, emit, sum);
+    cout.rdbuf(saved);
+    if (!ok) {
+        std::cerr << "cannot write scenarios to " << opt.emit << "\n";
+        return 1;
+    }
+
+    mon.cov.report(cout, opt.holes);
+    cout << "\n";
+    write_coverage_json(cout, "nonpipelined", opt, mon.cov, mon.cycles, sum);
+    return 0;
+}
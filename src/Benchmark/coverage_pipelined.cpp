@@ -0,0 +1,118 @@
+// Coverage-driven constrained-random regression for FPU_Pipeline_Top.
+// Runs batches of random programs (fp_stream_gen.h) from freshly seeded
+// registers through the cycle-accurate pipeline. Every retirement is
+// sampled into fp_coverage.h, and the generator is steered towards the
+// remaining holes. Stops when --saturate batches in a row add no new bin,
+// then reports the vectors and cycles it took to close.
+//
+//   fpu_coverage --seed 7 --weights 1,1,1,2 --dep-percent 50 --emit cov
+//
+// --emit DIR keeps every batch that added coverage as a scenario image for
+// both cores (DIR/pipelined, DIR/rv32f; see src/Farm/farm.h).
+
+#include "PipelinedFPUUnitsProcessor.h"
+#include "coverage_common.h"
+
+struct coverage_slot_t {
+    unsigned         op;
+    fp_operand_class a, b;
+};
+
+// Pairs the operands Execute was given with the flags the instruction
+// retires with. Issue and retirement are matched by PC; one program pass
+// is far longer than any in-flight instruction, so one slot per PC suffices.
+SC_MODULE(CoverageMonitor) {
+    sc_in<bool> clk;
+
+    FPU_Pipeline_Top* fpu;
+    fp_coverage       cov;
+    coverage_slot_t   slots[256];
+    int               fresh;      // new bins since last cleared
+    uint64_t          cycles;
+
+    void monitor() {
+        ++cycles;
+        const decode_to_execute_t& d = fpu->decode_to_execute.read();
+        if (d.valid) {
+            coverage_slot_t& s = slots[(d.pc.to_uint() / 4) % 256];
+            s.op = d.opcode.to_uint();
+            s.a  = classify_fp_operand(d.operand1.to_uint());
+            s.b  = classify_fp_operand(d.operand2.to_uint());
+        }
+        const execute_to_wb_t& e = fpu->execute_to_wb.read();
+        if (e.valid) {
+            const coverage_slot_t& s = slots[(e.pc.to_uint() / 4) % 256];
+            fresh += cov.sample(s.op, s.a, s.b, e.exceptions.to_uint());
+        }
+    }
+
+    SC_CTOR(CoverageMonitor) : fpu(nullptr), fresh(0), cycles(0) {
+        SC_METHOD(monitor);
+        sensitive << clk.neg();
+        dont_initialize();
+    }
+};
+
+// Writes one contributing batch for both encodings
+static bool emit_batch(const std::string& dir, uint64_t n, const uint32_t regs[32],
+                       const std::vector<bench_inst_t>& prog) {
+    std::vector<uint32_t> words;
+    for (const bench_inst_t& i : prog) words.push_back(fp_instruction_t(i.op, i.rd, i.rs1, i.rs2).to_word().to_uint());
+    bool ok = coverage_emit_image(dir, "pipelined", n, regs, words, prog.size() + DRAIN_CYCLES);
+    words.clear();
+    for (const bench_inst_t& i : prog) words.push_back(encode_rv32f(i));
+    return coverage_emit_image(dir, "rv32f", n, regs, words, prog.size() + DRAIN_CYCLES) && ok;
+}
+
+int sc_main(int argc, char* argv[]) {
+    coverage_options opt;
+    if (!parse_coverage_args(argc, argv, opt)) return 1;
+
+    sc_clock clk("clk", 10, SC_NS);
+    sc_signal<bool> reset;
+    sc_signal<bool> stall;
+
+    FPU_Pipeline_Top fpu("fpu_pipeline");
+    fpu.clk(clk);
+    fpu.reset(reset);
+    fpu.stall(stall);
+
+    CoverageMonitor mon("coverage");
+    mon.clk(clk);
+    mon.fpu = &fpu;
+
+    reset.write(true);
+    stall.write(false);
+    sc_start(25, SC_NS);
+    reset.write(false);
+
+    bench_null_buf null_buf;
+    std::streambuf* saved = cout.rdbuf(&null_buf);
+
+    auto run = [&](const uint32_t regs[32], const std::vector<bench_inst_t>& prog) {
+        std::vector<sc_uint<32>> words;
+        for (const bench_inst_t& i : prog) words.push_back(fp_instruction_t(i.op, i.rd, i.rs1, i.rs2).to_word());
+        fpu.fetch_stage->load_program(words.data(), (int)words.size());
+        for (int r = 1; r < 32; ++r) fpu.register_file->set_register_bits(r, regs[r]);
+        fpu.fetch_stage->pc = 0;
+
+        mon.fresh = 0;
+        sc_start(sc_time(10.0 * (prog.size() + DRAIN_CYCLES), SC_NS));
+        return mon.fresh;
+    };
+    auto emit = [&](uint64_t n, const uint32_t regs[32], const std::vector<bench_inst_t>& prog) {
+        return emit_batch(opt.emit, n, regs, prog);
+    };
+    coverage_summary_t sum;
+    bool ok = coverage_run(opt, mon.cov, mon.cycles, run, emit, sum);
+    cout.rdbuf(saved);
+    if (!ok) {
+        std::cerr << "cannot write scenarios to " << opt.emit << "\n";
+        return 1;
+    }
+
+    mon.cov.report(cout, opt.holes);
+    cout << "\n";
+    write_coverage_json(cout, "pipelined", opt, mon.cov, mon.cycles, sum);
+    return 0;
+}
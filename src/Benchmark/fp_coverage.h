@@ -0,0 +1,105 @@
+#ifndef FPU_FP_COVERAGE_H
+#define FPU_FP_COVERAGE_H
+
+// Functional coverage for FP execution: two crosses sampled per retired
+// instruction.
+//   operands: opcode x class(a) x class(b)
+//   flags:    opcode x {none, each exception flag}
+// Flag bits follow fp_exceptions in PipelinedFPUUnitsProcessor.h. Some
+// flag bins cannot be hit (e.g. divide-by-zero for fadd), which is why
+// closure is judged by saturation rather than by reaching 100%.
+
+#include "fp_stream_gen.h"
+#include <iomanip>
+#include <iostream>
+
+static const int FPCOV_FLAG_BINS = 6;
+static const char* const fpcov_flag_names[FPCOV_FLAG_BINS] = {
+    "none", "invalid", "overflow", "underflow", "div_by_zero", "inexact"
+};
+static const char* const fpcov_op_names[4] = {"fadd", "fsub", "fmul", "fdiv"};
+
+class fp_coverage {
+public:
+    static const int OPERAND_BINS = 4 * FPC_NUM * FPC_NUM;
+    static const int FLAG_BINS    = 4 * FPCOV_FLAG_BINS;
+
+    fp_coverage() : samples(0) {
+        for (uint64_t& h : operand_hits) h = 0;
+        for (uint64_t& h : flag_hits) h = 0;
+    }
+
+    // Returns the number of bins hit for the first time
+    int sample(unsigned op, fp_operand_class a, fp_operand_class b, unsigned exc) {
+        if (op > 3) return 0;
+        ++samples;
+        int fresh = hit(operand_hits[(op * FPC_NUM + a) * FPC_NUM + b]);
+        if (!(exc & 0x1F)) fresh += hit(flag_hits[op * FPCOV_FLAG_BINS]);
+        for (int f = 0; f < 5; ++f)
+            if (exc & (1u << f)) fresh += hit(flag_hits[op * FPCOV_FLAG_BINS + 1 + f]);
+        return fresh;
+    }
+
+    int operand_covered() const { return covered(operand_hits, OPERAND_BINS); }
+    int flag_covered() const { return covered(flag_hits, FLAG_BINS); }
+    int total_bins() const { return OPERAND_BINS + FLAG_BINS; }
+    int total_covered() const { return operand_covered() + flag_covered(); }
+    uint64_t sample_count() const { return samples; }
+
+    // Steers a generator towards the holes: an opcode or operand class
+    // weighs more the more of its bins are still empty
+    void steer(fp_stream_config& cfg, const fp_stream_config& base) const {
+        unsigned op_holes[4] = {0, 0, 0, 0}, class_holes[FPC_NUM] = {0};
+        for (int op = 0; op < 4; ++op)
+            for (int a = 0; a < FPC_NUM; ++a)
+                for (int b = 0; b < FPC_NUM; ++b)
+                    if (!operand_hits[(op * FPC_NUM + a) * FPC_NUM + b]) {
+                        ++op_holes[op];
+                        ++class_holes[a];
+                        ++class_holes[b];
+                    }
+        for (int op = 0; op < 4; ++op)
+            cfg.op_weight[op] = base.op_weight[op] ? base.op_weight[op] * (1 + op_holes[op]) : 0;
+        for (int c = 0; c < FPC_NUM; ++c)
+            cfg.class_weight[c] = base.class_weight[c] ? base.class_weight[c] * (1 + class_holes[c]) : 0;
+    }
+
+    void report(std::ostream& os, bool holes) const {
+        os << "operand cross   " << operand_covered() << " / " << OPERAND_BINS << "\n"
+           << "flag cross      " << flag_covered() << " / " << FLAG_BINS << "\n";
+        os << "\n        ";
+        for (int f = 0; f < FPCOV_FLAG_BINS; ++f) os << " " << std::setw(11) << fpcov_flag_names[f];
+        os << "\n";
+        for (int op = 0; op < 4; ++op) {
+            os << std::left << std::setw(8) << fpcov_op_names[op] << std::right;
+            for (int f = 0; f < FPCOV_FLAG_BINS; ++f) os << " " << std::setw(11) << flag_hits[op * FPCOV_FLAG_BINS + f];
+            os << "\n";
+        }
+        if (!holes) return;
+        os << "\nholes:\n";
+        for (int op = 0; op < 4; ++op) {
+            for (int a = 0; a < FPC_NUM; ++a)
+                for (int b = 0; b < FPC_NUM; ++b)
+                    if (!operand_hits[(op * FPC_NUM + a) * FPC_NUM + b])
+                        os << "  " << fpcov_op_names[op] << " " << fp_operand_class_names[a] << ", "
+                           << fp_operand_class_names[b] << "\n";
+            for (int f = 0; f < FPCOV_FLAG_BINS; ++f)
+                if (!flag_hits[op * FPCOV_FLAG_BINS + f])
+                    os << "  " << fpcov_op_names[op] << " flag " << fpcov_flag_names[f] << "\n";
+        }
+    }
+
+private:
+    static int hit(uint64_t& h) { return h++ == 0; }
+    static int covered(const uint64_t* h, int n) {
+        int c = 0;
+        for (int i = 0; i < n; ++i) c += h[i] != 0;
+        return c;
+    }
+
+    uint64_t operand_hits[OPERAND_BINS];
+    uint64_t flag_hits[FLAG_BINS];
+    uint64_t samples;
+};
+
+#endif // FPU_FP_COVERAGE_H
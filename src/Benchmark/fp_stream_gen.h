@@ -0,0 +1,110 @@
+#ifndef FPU_FP_STREAM_GEN_H
+#define FPU_FP_STREAM_GEN_H
+
+// Constrained-random FP instruction streams. Opcodes are drawn from a
+// weighted mix, each source operand reuses a recent destination with a
+// given probability (dependency distance 1..dep_max), and registers are
+// seeded per operand class, biased towards zero, denormal, underflow and
+// overflow boundaries, infinity and NaN. Produces abstract bench_inst_t;
+// each core encodes them itself (fp_instruction_t or RV32F OP-FP).
+
+#include "bench_common.h"
+
+enum fp_operand_class {
+    FPC_ZERO = 0,
+    FPC_DENORMAL,
+    FPC_TINY,        // smallest normal binades: products and quotients underflow
+    FPC_NORMAL,
+    FPC_HUGE,        // largest finite binades: sums and products overflow
+    FPC_INF,
+    FPC_NAN,
+    FPC_NUM
+};
+
+static const char* const fp_operand_class_names[FPC_NUM] = {
+    "zero", "denormal", "tiny", "normal", "huge", "inf", "nan"
+};
+
+static inline fp_operand_class classify_fp_operand(uint32_t v) {
+    uint32_t exp = (v >> 23) & 0xFF, man = v & 0x7FFFFF;
+    if (exp == 0) return man ? FPC_DENORMAL : FPC_ZERO;
+    if (exp == 0xFF) return man ? FPC_NAN : FPC_INF;
+    if (exp < 0x10) return FPC_TINY;
+    if (exp > 0xEF) return FPC_HUGE;
+    return FPC_NORMAL;
+}
+
+struct fp_stream_config {
+    unsigned op_weight[4]         = {1, 1, 1, 1};            // add, sub, mul, div
+    unsigned class_weight[FPC_NUM] = {2, 2, 2, 6, 2, 1, 1};  // register seeding
+    unsigned dep_percent          = 30;    // chance a source reads a recent rd
+    unsigned dep_max              = 4;     // dependency distance 1..dep_max
+};
+
+class fp_stream_gen {
+public:
+    fp_stream_gen(const fp_stream_config& c, uint32_t seed) : cfg(c), rng(seed) {}
+
+    fp_stream_config& config() { return cfg; }
+
+    uint32_t random_value(fp_operand_class c) {
+        uint32_t sign = (rng.next() & 1) << 31, man = rng.next() & 0x7FFFFF;
+        switch (c) {
+            case FPC_ZERO:     return sign;
+            case FPC_DENORMAL: return sign | (man ? man : 1);
+            case FPC_TINY:     return sign | ((1 + rng.next() % 0xF) << 23) | man;
+            case FPC_HUGE:     return sign | ((0xF0 + rng.next() % 0xF) << 23) | man;
+            case FPC_INF:      return sign | 0x7F800000;
+            case FPC_NAN:      return sign | 0x7F800000 | (rng.next() & 1 ? 0x400000 : 0) | (man ? man : 1);
+            default:           return sign | ((0x60 + rng.next() % 0x40) << 23) | man;
+        }
+    }
+
+    // A value of a class drawn from class_weight
+    uint32_t random_operand() { return random_value((fp_operand_class)pick(cfg.class_weight, FPC_NUM)); }
+
+    // An opcode drawn from op_weight
+    unsigned random_op() { return pick(cfg.op_weight, 4); }
+
+    // f1..f31; f0 is left at zero
+    void seed_registers(uint32_t regs[32]) {
+        regs[0] = 0;
+        for (int r = 1; r < 32; ++r) regs[r] = random_operand();
+    }
+
+    std::vector<bench_inst_t> program(int count) {
+        std::vector<bench_inst_t> prog;
+        for (int i = 0; i < count; ++i) {
+            bench_inst_t in;
+            in.op  = random_op();
+            in.rd  = 1 + rng.next() % 31;
+            in.rs1 = source(prog);
+            in.rs2 = source(prog);
+            prog.push_back(in);
+        }
+        return prog;
+    }
+
+private:
+    unsigned pick(const unsigned* w, unsigned n) {
+        unsigned total = 0;
+        for (unsigned i = 0; i < n; ++i) total += w[i];
+        if (!total) return 0;
+        unsigned p = rng.next() % total, i = 0;
+        while (p >= w[i]) p -= w[i++];
+        return i;
+    }
+
+    unsigned source(const std::vector<bench_inst_t>& prog) {
+        if (!prog.empty() && cfg.dep_max && rng.next() % 100 < cfg.dep_percent) {
+            size_t dist = 1 + rng.next() % cfg.dep_max;
+            if (dist <= prog.size()) return prog[prog.size() - dist].rd;
+        }
+        return 1 + rng.next() % 31;
+    }
+
+    fp_stream_config cfg;
+    bench_rng        rng;
+};
+
+#endif // FPU_FP_STREAM_GEN_H
@@ -0,0 +1,28 @@
+#!/bin/sh
+# Runs all benchmark mixes on both models and writes one JSON document:
+#   run_benchmarks.sh <build-dir> [output.json] [cycles]
+# The commit hash is recorded so results can be tracked across commits.
+set -e
+
+BUILD_DIR=${1:?usage: run_benchmarks.sh <build-dir> [output.json] [cycles]}
+OUT=${2:-bench_results.json}
+CYCLES=${3:-2000000}
+MIXES="add-only mul-only div-heavy mixed special"
+
+COMMIT=$(git -C "$(dirname "$0")" rev-parse --short HEAD 2>/dev/null || echo unknown)
+LINES=$(mktemp)
+trap 'rm -f "$LINES"' EXIT
+
+for model in pipelined nonpipelined; do
+    for mix in $MIXES; do
+        echo "running $model / $mix ($CYCLES cycles)" >&2
+        "$BUILD_DIR/fpu_bench_$model" --mix "$mix" --cycles "$CYCLES" --json "$LINES"
+    done
+done
+
+{
+    echo "{\"commit\": \"$COMMIT\", \"date\": \"$(date -u +%Y-%m-%dT%H:%M:%SZ)\", \"runs\": ["
+    sed '$!s/$/,/' "$LINES"
+    echo "]}"
+} > "$OUT"
+echo "wrote $OUT" >&2
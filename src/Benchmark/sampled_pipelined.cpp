@@ -0,0 +1,249 @@
+// Sampled simulation of FPU_Pipeline_Top (SMARTS-style systematic sampling).
+// The dynamic instruction stream (the benchmark program, looped) is split
+// into intervals. Most of each interval runs functionally through
+// Execute::evaluate() with the register file updated directly; the end of
+// the interval is handed to the cycle-accurate pipeline for a warm-up and a
+// measured window. Per-window CPI is reported together with totals
+// extrapolated to the whole run.
+//
+//   fpu_sampled --instructions 1000000000 --interval 1000000 --window 10000
+
+#include "PipelinedFPUUnitsProcessor.h"
+#include "bench_common.h"
+#include <cmath>
+
+// Counts fetches/retirements and keeps Fetch looping over the program,
+// or idle while the pipeline is being drained
+SC_MODULE(SampledDriver) {
+    sc_in<bool> clk;
+
+    FPU_Pipeline_Top* fpu;
+    uint64_t cycles, fetched, retired;
+    bool     draining;
+
+    void monitor() {
+        ++cycles;
+        if (fpu->fetch_to_decode.read().valid) ++fetched;
+        if (fpu->execute_to_wb.read().valid) ++retired;
+        Fetch* f = fpu->fetch_stage;
+        if (!draining && f->pc >= f->imem_size) f->pc = 0;
+    }
+
+    SC_CTOR(SampledDriver) : fpu(nullptr), cycles(0), fetched(0), retired(0), draining(false) {
+        SC_METHOD(monitor);
+        sensitive << clk.neg();
+        dont_initialize();
+    }
+};
+
+struct sampled_options {
+    std::string mix          = "mixed";
+    uint32_t    seed         = 1;
+    uint64_t    instructions = 100000000;
+    uint64_t    interval     = 1000000;
+    uint64_t    warmup       = 2000;
+    uint64_t    window       = 10000;
+    bool        reference    = false;   // also simulate everything in detail
+    bool        verbose      = false;
+};
+
+static void sampled_usage(const char* prog) {
+    std::cerr << "usage: " << prog << " [--mix NAME] [--seed N] [--instructions N] [--interval N]\n"
+              << "       [--warmup N] [--window N] [--reference] [--verbose]\n";
+}
+
+static bool parse_sampled_args(int argc, char* argv[], sampled_options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        bool has_val = i + 1 < argc;
+        if (a == "--mix" && has_val) opt.mix = argv[++i];
+        else if (a == "--seed" && has_val) opt.seed = (uint32_t)std::strtoul(argv[++i], nullptr, 0);
+        else if (a == "--instructions" && has_val) opt.instructions = std::strtoull(argv[++i], nullptr, 0);
+        else if (a == "--interval" && has_val) opt.interval = std::strtoull(argv[++i], nullptr, 0);
+        else if (a == "--warmup" && has_val) opt.warmup = std::strtoull(argv[++i], nullptr, 0);
+        else if (a == "--window" && has_val) opt.window = std::strtoull(argv[++i], nullptr, 0);
+        else if (a == "--reference") opt.reference = true;
+        else if (a == "--verbose") opt.verbose = true;
+        else { sampled_usage(argv[0]); return false; }
+    }
+    if (!find_bench_mix(opt.mix) || opt.window == 0 || opt.warmup + opt.window > opt.interval) {
+        sampled_usage(argv[0]);
+        return false;
+    }
+    return true;
+}
+
+struct sampled_sim {
+    FPU_Pipeline_Top&                fpu;
+    SampledDriver&                   drv;
+    const std::vector<bench_inst_t>& prog;
+    uint64_t                         pc;       // next program index
+    uint32_t                         regs[32];
+    sc_uint<8>                       flags;
+
+    sampled_sim(FPU_Pipeline_Top& f, SampledDriver& d, const std::vector<bench_inst_t>& p)
+        : fpu(f), drv(d), prog(p), pc(0), flags(0) {}
+
+    void functional(uint64_t count) {
+        Execute* ex = fpu.execute_stage;
+        for (uint64_t i = 0; i < count; ++i) {
+            const bench_inst_t& in = prog[pc];
+            sc_uint<8> exc = 0;
+            sc_uint<32> r = ex->evaluate(in.op, regs[in.rs1], regs[in.rs2], exc);
+            if (in.rd != 0) regs[in.rd] = r.to_uint();
+            flags |= exc;
+            if (++pc == prog.size()) pc = 0;
+        }
+    }
+
+    void run_cycles(uint64_t n) { sc_start(sc_time(10.0 * n, SC_NS)); }
+
+    // Architectural state -> pipeline, fetching from the current PC
+    void enter_detailed() {
+        for (int r = 1; r < 32; ++r) fpu.register_file->set_register_bits(r, regs[r]);
+        fpu.register_file->clear_exception_flags();
+        fpu.register_file->set_exception_flag(flags);
+        fpu.fetch_stage->pc = pc;
+        drv.draining = false;
+    }
+
+    // Stop fetching, drain, pipeline -> architectural state
+    void leave_detailed() {
+        Fetch* f = fpu.fetch_stage;
+        pc = f->pc.to_uint64() % prog.size();
+        drv.draining = true;
+        f->pc = f->imem_size;
+        run_cycles(DRAIN_CYCLES);
+        for (int r = 0; r < 32; ++r) regs[r] = fpu.register_file->read_register(r).to_uint();
+        flags = fpu.register_file->get_exception_flags();
+    }
+};
+
+struct window_result_t {
+    uint64_t start;            // dynamic instruction index of the window
+    uint64_t fetched, retired, cycles;
+    double cpi() const { return retired ? (double)cycles / retired : 0.0; }
+};
+
+int sc_main(int argc, char* argv[]) {
+    sampled_options opt;
+    if (!parse_sampled_args(argc, argv, opt)) return 1;
+    const bench_mix_t& mix = *find_bench_mix(opt.mix);
+
+    sc_clock clk("clk", 10, SC_NS);
+    sc_signal<bool> reset;
+    sc_signal<bool> stall;
+
+    FPU_Pipeline_Top fpu("fpu_pipeline");
+    fpu.clk(clk);
+    fpu.reset(reset);
+    fpu.stall(stall);
+
+    SampledDriver driver("driver");
+    driver.clk(clk);
+    driver.fpu = &fpu;
+
+    reset.write(true);
+    stall.write(false);
+    sc_start(25, SC_NS);
+    reset.write(false);
+
+    std::vector<bench_inst_t> prog = make_bench_program(mix, 256, opt.seed);
+    std::vector<sc_uint<32>> words;
+    for (const bench_inst_t& i : prog)
+        words.push_back(fp_instruction_t(i.op, i.rd, i.rs1, i.rs2).to_word());
+    fpu.fetch_stage->load_program(words.data(), (int)words.size());
+
+    sampled_sim sim(fpu, driver, prog);
+    bench_seed_registers(mix, sim.regs);
+    driver.draining = true;
+    fpu.fetch_stage->pc = fpu.fetch_stage->imem_size;
+
+    bench_null_buf null_buf;
+    std::streambuf* saved = cout.rdbuf(&null_buf);
+
+    bench_timer timer;
+    std::vector<window_result_t> windows;
+    uint64_t done = 0, functional_insts = 0;
+    while (done < opt.instructions) {
+        uint64_t len = std::min(opt.interval, opt.instructions - done);
+        uint64_t detail = std::min(len, opt.warmup + opt.window);
+        uint64_t ff = len - detail;
+        sim.functional(ff);
+        functional_insts += ff;
+
+        // One instruction is fetched per cycle, so instruction counts map to cycles
+        sim.enter_detailed();
+        uint64_t warm = detail > opt.window ? detail - opt.window : 0;
+        sim.run_cycles(warm);
+        window_result_t w;
+        w.start = done + ff + warm;
+        uint64_t c0 = driver.cycles, f0 = driver.fetched, r0 = driver.retired;
+        sim.run_cycles(detail - warm);
+        w.cycles  = driver.cycles - c0;
+        w.fetched = driver.fetched - f0;
+        w.retired = driver.retired - r0;
+        sim.leave_detailed();
+        if (w.fetched) windows.push_back(w);
+        done += len;
+    }
+    double secs = timer.seconds();
+
+    // Extrapolate: every window stands for an equal share of the run
+    double cycles_per_fetch = 0, retire_ratio = 0, cpi_sum = 0, cpi_sq = 0;
+    for (const window_result_t& w : windows) {
+        cycles_per_fetch += (double)w.cycles / w.fetched;
+        retire_ratio += (double)w.retired / w.fetched;
+        cpi_sum += w.cpi();
+        cpi_sq += w.cpi() * w.cpi();
+    }
+    size_t n = windows.size();
+    double est_cycles  = n ? cycles_per_fetch / n * opt.instructions : 0;
+    double est_retired = n ? retire_ratio / n * opt.instructions : 0;
+    double cpi_mean    = n ? cpi_sum / n : 0;
+    double cpi_stddev  = n > 1 ? std::sqrt(std::max(0.0, (cpi_sq - n * cpi_mean * cpi_mean) / (n - 1))) : 0;
+    double cpi_ci95    = n > 1 ? 1.96 * cpi_stddev / std::sqrt((double)n) : 0;
+
+    // Optional ground truth: the whole run in detail from the same start state
+    double ref_cycles = 0, ref_retired = 0, ref_secs = 0;
+    if (opt.reference) {
+        sampled_sim ref(fpu, driver, prog);
+        bench_seed_registers(mix, ref.regs);
+        ref.enter_detailed();
+        bench_timer ref_timer;
+        uint64_t c0 = driver.cycles, r0 = driver.retired;
+        ref.run_cycles(opt.instructions);
+        ref.leave_detailed();
+        ref_cycles  = (double)(driver.cycles - c0 - DRAIN_CYCLES);
+        ref_retired = (double)(driver.retired - r0);
+        ref_secs    = ref_timer.seconds();
+    }
+
+    cout.rdbuf(saved);
+    cout << std::dec;
+    if (opt.verbose) {
+        cout << "window  start_inst      fetched  retired  cycles   cpi\n";
+        for (size_t i = 0; i < n; ++i) {
+            const window_result_t& w = windows[i];
+            cout << std::setw(6) << i << "  " << std::setw(14) << w.start << "  " << std::setw(7) << w.fetched
+                 << "  " << std::setw(7) << w.retired << "  " << std::setw(7) << w.cycles << "  "
+                 << std::fixed << std::setprecision(4) << w.cpi() << "\n";
+        }
+    }
+    cout << std::defaultfloat;
+    cout << "{\"model\": \"pipelined-sampled\", \"mix\": \"" << mix.name << "\", \"seed\": " << opt.seed
+         << ", \"instructions\": " << opt.instructions << ", \"interval\": " << opt.interval
+         << ", \"warmup\": " << opt.warmup << ", \"window\": " << opt.window
+         << ", \"windows\": " << n << ", \"functional_instructions\": " << functional_insts
+         << ", \"cpi_mean\": " << cpi_mean << ", \"cpi_ci95\": " << cpi_ci95
+         << ", \"est_cycles\": " << (uint64_t)est_cycles << ", \"est_retired\": " << (uint64_t)est_retired
+         << ", \"est_cpi\": " << (est_retired ? est_cycles / est_retired : 0.0)
+         << ", \"wall_seconds\": " << secs;
+    if (opt.reference) {
+        cout << ", \"ref_cycles\": " << (uint64_t)ref_cycles << ", \"ref_retired\": " << (uint64_t)ref_retired
+             << ", \"ref_cpi\": " << (ref_retired ? ref_cycles / ref_retired : 0.0)
+             << ", \"ref_wall_seconds\": " << ref_secs;
+    }
+    cout << "}\n";
+    return 0;
+}
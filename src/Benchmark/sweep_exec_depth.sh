@@ -0,0 +1,48 @@
+#!/bin/sh
+# Builds Testbench.cpp once per Execute split mask (FPU_EXEC_SPLITS, see
+# exec_split in PipelinedFPUUnitsProcessor.h) and reports the Execute depth,
+# i.e. the latency of a non-divide instruction in Execute, against the cycle
+# of the test program's last writeback. The directed checks must pass at
+# every depth; the sweep exits non-zero if any mask fails one:
+#   sweep_exec_depth.sh [masks...]        (default: all 16)
+# Needs SYSTEMC_HOME; CXX defaults to c++.
+set -e
+
+: "${SYSTEMC_HOME:?SYSTEMC_HOME must point to a SystemC installation}"
+CXX=${CXX:-c++}
+ROOT=$(cd "$(dirname "$0")/../.." && pwd)
+MASKS=${*:-"0 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15"}
+
+SCLIB=$SYSTEMC_HOME/lib
+[ -d "$SCLIB" ] || SCLIB=$SYSTEMC_HOME/lib-linux64
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+failed=""
+printf '%-6s %-38s %6s %10s %8s\n' splits phases depth last_wb tests
+for m in $MASKS; do
+    names=""
+    [ $((m & 1)) -ne 0 ] && names="$names+decompose"
+    [ $((m & 2)) -ne 0 ] && names="$names+prepare"
+    [ $((m & 4)) -ne 0 ] && names="$names+combine"
+    [ $((m & 8)) -ne 0 ] && names="$names+normalize"
+    names=${names#+}
+
+    "$CXX" -std=c++17 -O2 -DFPU_EXEC_SPLITS="$m" -I"$SYSTEMC_HOME/include" -I"$ROOT" \
+        "$ROOT/Testbench.cpp" -L"$SCLIB" -Wl,-rpath,"$SCLIB" -lsystemc -lpthread -o "$WORK/tb_$m"
+    "$WORK/tb_$m" > "$WORK/out_$m"
+
+    depth=$(sed -n 's/^Execute depth: \([0-9]*\).*/\1/p' "$WORK/out_$m")
+    last=$(sed -n 's/.*Last writeback at cycle: \([-0-9]*\).*/\1/p' "$WORK/out_$m")
+    tests=$(sed -n 's/^Passed: \([0-9]*\)  Failed: \([0-9]*\).*/\1\/\2/p' "$WORK/out_$m")
+    printf '%-6s %-38s %6s %10s %8s\n' "$m" "${names:-none}" "$depth" "$last" "$tests"
+    case $tests in
+    */0) ;;
+    *) failed="$failed $m" ;;
+    esac
+done
+
+if [ -n "$failed" ]; then
+    echo "directed checks failed for masks:$failed" >&2
+    exit 1
+fi
@@ -0,0 +1,353 @@
+// Batch test-vector runs of the pipelined Execute stage. Vectors are read
+// from an mmapped FpuVectorFile.h file and streamed one per cycle by
+// VectorDriver.h; results go to an mmapped result file. Millions of vectors
+// cost about one clock each, with no text I/O and no register setup.
+//
+//   fpu_vectors --generate vectors.fpv 1000000 --mix special --seed 3
+//   fpu_vectors vectors.fpv results.fpr --json run.json
+//
+// --generate draws operands per fp_stream_gen.h operand class (normal ones
+// only, except for the special mix) and takes the expected result and flags
+// from the host's IEEE arithmetic (host_reference), not from the model under
+// test. A run checks the cycle-accurate pipe, divider pool and result port
+// against it. Exits 1 if any vector fails.
+//
+// The same files are the golden database of Testbench.cpp --vectors and the
+// SystemVerilog testbench (src/Testbench/fpu_vector_db.svh):
+//   fpu_vectors --import directed.fpv "src/Testbench/directed_vectors.txt"
+//   fpu_vectors --export-hex directed.fpv directed   (directed.hex, directed.idx.hex)
+//   fpu_vectors --info vectors.fpv --select fdiv:nan  (vectors per class bucket)
+
+#include "VectorDriver.h"
+#include "fp_stream_gen.h"
+#include <cfenv>
+#include <cfloat>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+static_assert(FPC_NUM == 7 && FPC_NUM <= (int)FPU_VECTOR_CLASSES, "FpuVectorFile.h class tags follow fp_operand_class");
+
+struct vectors_options {
+    std::string vectors;
+    std::string results;
+    std::string json;           // empty: print JSON to stdout
+    uint64_t    generate = 0;   // vectors to write instead of running
+    std::string import;         // directed vector text to write instead of running
+    std::string export_hex;     // $readmemh file prefix to write instead of running
+    bool        info     = false;
+    std::string select;         // --info: OP:A:B buckets to list
+    std::string mix      = "mixed";
+    uint32_t    seed     = 1;
+    unsigned    show     = 10;  // failing vectors listed on stderr
+};
+
+static void vectors_usage(const char* prog) {
+    std::cerr << "usage: " << prog << " [--json FILE] [--show N] VECTORS RESULTS\n"
+              << "       " << prog << " --generate VECTORS COUNT [--mix NAME] [--seed N]\n"
+              << "       " << prog << " --import VECTORS TEXT\n"
+              << "       " << prog << " --export-hex VECTORS PREFIX\n"
+              << "       " << prog << " --info VECTORS [--select OP:A:B]\n";
+}
+
+static bool parse_vectors_args(int argc, char* argv[], vectors_options& opt) {
+    std::vector<std::string> files;
+    bool generate = false, import = false, export_hex = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        bool has_val = i + 1 < argc;
+        if (a == "--generate") generate = true;
+        else if (a == "--import") import = true;
+        else if (a == "--export-hex") export_hex = true;
+        else if (a == "--info") opt.info = true;
+        else if (a == "--select" && has_val) opt.select = argv[++i];
+        else if (a == "--json" && has_val) opt.json = argv[++i];
+        else if (a == "--show" && has_val) opt.show = (unsigned)std::strtoul(argv[++i], nullptr, 0);
+        else if (a == "--mix" && has_val) opt.mix = argv[++i];
+        else if (a == "--seed" && has_val) opt.seed = (uint32_t)std::strtoul(argv[++i], nullptr, 0);
+        else if (a.compare(0, 2, "--") != 0) files.push_back(a);
+        else { vectors_usage(argv[0]); return false; }
+    }
+    int modes = generate + import + export_hex + opt.info;
+    int dummy;
+    if (modes > 1 || files.size() != (opt.info ? 1u : 2u) || !find_bench_mix(opt.mix) ||
+        (!opt.select.empty() && !fpu_vector_parse_select(opt.select, dummy, dummy, dummy))) {
+        vectors_usage(argv[0]);
+        return false;
+    }
+    opt.vectors = files[0];
+    if (opt.info) return true;
+    if (import) {
+        opt.import = files[1];
+    } else if (export_hex) {
+        opt.export_hex = files[1];
+    } else if (generate) {
+        opt.generate = std::strtoull(files[1].c_str(), nullptr, 0);
+        if (!opt.generate) { vectors_usage(argv[0]); return false; }
+    } else {
+        opt.results = files[1];
+    }
+    return true;
+}
+
+// Expected result and fp_exceptions of one operation, from the host's
+// binary32 arithmetic with round to nearest even and its <cfenv> flags
+// (tininess after rounding, as RISC-V has it). NaN results are RISC-V's
+// canonical 0x7FC00000. Returns false where the host cannot serve as the
+// reference: float not IEEE single, evaluated wider, or denormals flushed.
+static bool host_reference(int op, uint32_t a, uint32_t b, uint32_t& result, uint8_t& exceptions) {
+    static const volatile float min_normal = FLT_MIN;
+    if (!std::numeric_limits<float>::is_iec559 || FLT_EVAL_METHOD != 0 || min_normal / 2 == 0) return false;
+    if (std::fegetround() != FE_TONEAREST && std::fesetround(FE_TONEAREST) != 0) return false;
+
+    float fa, fb;
+    std::memcpy(&fa, &a, 4);
+    std::memcpy(&fb, &b, 4);
+    volatile float x = fa, y = fb, r;   // no constant folding across the flag reads
+    std::feclearexcept(FE_ALL_EXCEPT);
+    switch (op) {
+    case 0:  r = x + y; break;
+    case 1:  r = x - y; break;
+    case 2:  r = x * y; break;
+    default: r = x / y; break;
+    }
+    int raised = std::fetestexcept(FE_ALL_EXCEPT);
+    float fr = r;
+    std::memcpy(&result, &fr, 4);
+    if (fr != fr) result = 0x7FC00000;
+
+    exceptions = 0;
+    if (raised & FE_INVALID)   exceptions |= FP_INVALID_OP;
+    if (raised & FE_DIVBYZERO) exceptions |= FP_DIVIDE_BY_ZERO;
+    if (raised & FE_OVERFLOW)  exceptions |= FP_OVERFLOW;
+    if (raised & FE_UNDERFLOW) exceptions |= FP_UNDERFLOW;
+    if (raised & FE_INEXACT)   exceptions |= FP_INEXACT;
+    return true;
+}
+
+static int generate_vectors(const vectors_options& opt) {
+    const bench_mix_t& mix = *find_bench_mix(opt.mix);
+    fp_stream_config cfg;
+    for (int i = 0; i < 4; ++i) cfg.op_weight[i] = mix.weight[i];
+    if (!mix.special_operands)
+        for (int c = 0; c < FPC_NUM; ++c) cfg.class_weight[c] = c == FPC_NORMAL;
+    fp_stream_gen gen(cfg, opt.seed);
+
+    std::vector<fpu_vector_t> v(opt.generate);
+    uint64_t unchecked = 0;
+    for (fpu_vector_t& t : v) {
+        t.opcode  = (uint8_t)gen.random_op();
+        t.a       = gen.random_operand();
+        t.b       = gen.random_operand();
+        t.classes = fpu_vector_classes(classify_fp_operand(t.a), classify_fp_operand(t.b));
+        t.flags   = host_reference(t.opcode, t.a, t.b, t.expected, t.expected_exceptions) ? FPU_VECTOR_CHECK : 0;
+        if (!t.flags) ++unchecked;
+    }
+    if (!fpu_vector_write_file(opt.vectors, v)) {
+        std::cerr << "cannot write " << opt.vectors << "\n";
+        return 1;
+    }
+    std::cout << std::dec << v.size() << " " << mix.name << " vectors written to " << opt.vectors;
+    if (unchecked) std::cout << " (" << unchecked << " unchecked: no IEEE host arithmetic)";
+    std::cout << "\n";
+    return 0;
+}
+
+// Directed vectors, one per line: "OP A B [EXPECTED EXCEPTIONS]" with OP a
+// name or 0..3 and numbers in C syntax; '#' starts a comment. A line without
+// an expectation is run but not checked.
+static int import_vectors(const vectors_options& opt) {
+    std::ifstream in(opt.import.c_str());
+    if (!in) {
+        std::cerr << "cannot open " << opt.import << "\n";
+        return 1;
+    }
+    std::vector<fpu_vector_t> v;
+    std::string line;
+    for (unsigned n = 1; std::getline(in, line); ++n) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream ls(line);
+        std::vector<std::string> f;
+        for (std::string w; ls >> w;) f.push_back(w);
+        if (f.empty()) continue;
+
+        int op = -1;
+        for (int i = 0; i < 4; ++i)
+            if (f[0] == fpu_vector_op_names[i] || f[0] == std::to_string(i)) op = i;
+        if (op < 0 || (f.size() != 3 && f.size() != 5)) {
+            std::cerr << opt.import << ":" << n << ": expected OP A B [EXPECTED EXCEPTIONS]\n";
+            return 1;
+        }
+        fpu_vector_t t = fpu_vector_t();
+        t.opcode = (uint8_t)op;
+        t.flags  = f.size() == 5 ? FPU_VECTOR_CHECK : 0;
+        t.a      = (uint32_t)std::strtoul(f[1].c_str(), nullptr, 0);
+        t.b      = (uint32_t)std::strtoul(f[2].c_str(), nullptr, 0);
+        if (f.size() == 5) {
+            t.expected            = (uint32_t)std::strtoul(f[3].c_str(), nullptr, 0);
+            t.expected_exceptions = (uint8_t)std::strtoul(f[4].c_str(), nullptr, 0);
+        }
+        t.classes = fpu_vector_classes(classify_fp_operand(t.a), classify_fp_operand(t.b));
+        v.push_back(t);
+    }
+    if (!fpu_vector_write_file(opt.vectors, v)) {
+        std::cerr << "cannot write " << opt.vectors << "\n";
+        return 1;
+    }
+    std::cout << std::dec << v.size() << " vectors from " << opt.import << " written to " << opt.vectors << "\n";
+    return 0;
+}
+
+// PREFIX.hex: one 128-bit word per vector, {opcode, flags,
+// expected_exceptions, classes, a, b, expected} from the top byte down.
+// PREFIX.idx.hex: the class index as 32-bit words. Both load with $readmemh.
+static int export_hex(const vectors_options& opt) {
+    std::string error;
+    fpu_vector_map in;
+    if (!in.open_vectors(opt.vectors, error)) { std::cerr << error << "\n"; return 1; }
+    uint64_t n = in.count();
+
+    std::string vec_path = opt.export_hex + ".hex", idx_path = opt.export_hex + ".idx.hex";
+    FILE* vf = std::fopen(vec_path.c_str(), "w");
+    FILE* xf = std::fopen(idx_path.c_str(), "w");
+    if (!vf || !xf) {
+        if (vf) std::fclose(vf);
+        if (xf) std::fclose(xf);
+        std::cerr << "cannot write " << (vf ? idx_path : vec_path) << "\n";
+        return 1;
+    }
+    std::fprintf(vf, "// %llu vectors from %s: opcode flags expected_exceptions classes a b expected\n",
+                 (unsigned long long)n, opt.vectors.c_str());
+    for (uint64_t i = 0; i < n; ++i) {
+        const fpu_vector_t& t = in.vectors()[i];
+        std::fprintf(vf, "%02x%02x%02x%02x%08x%08x%08x\n", t.opcode, t.flags, t.expected_exceptions, t.classes, t.a,
+                     t.b, t.expected);
+    }
+    std::fprintf(xf, "// class index of %s: %u bucket starts, then %llu vector numbers\n", opt.vectors.c_str(),
+                 FPU_VECTOR_BUCKETS + 1, (unsigned long long)n);
+    for (uint64_t i = 0; i < fpu_vector_index_words(n); ++i) std::fprintf(xf, "%08x\n", in.index()[i]);
+    bool ok = !std::ferror(vf) && !std::ferror(xf);
+    ok = std::fclose(vf) == 0 && ok;
+    ok = std::fclose(xf) == 0 && ok;
+    if (!ok) {
+        std::cerr << "cannot write " << opt.export_hex << ".*hex\n";
+        return 1;
+    }
+    std::cout << std::dec << n << " vectors written to " << vec_path << " and " << idx_path << "\n";
+    return 0;
+}
+
+// Vectors per non-empty class bucket
+static int vector_info(const vectors_options& opt) {
+    std::string error;
+    fpu_vector_map in;
+    if (!in.open_vectors(opt.vectors, error)) { std::cerr << error << "\n"; return 1; }
+    int sel_op = -1, sel_a = -1, sel_b = -1;
+    if (!opt.select.empty()) fpu_vector_parse_select(opt.select, sel_op, sel_a, sel_b);
+
+    uint64_t total = 0;
+    for (int op = 0; op < 4; ++op)
+        for (int ca = 0; ca < FPC_NUM; ++ca)
+            for (int cb = 0; cb < FPC_NUM; ++cb) {
+                if ((sel_op >= 0 && sel_op != op) || (sel_a >= 0 && sel_a != ca) || (sel_b >= 0 && sel_b != cb))
+                    continue;
+                unsigned k = fpu_vector_bucket(op, ca, cb);
+                uint64_t n = in.bucket_end(k) - in.bucket_begin(k);
+                if (!n) continue;
+                std::cout << std::left << std::setw(5) << fpu_vector_op_names[op] << std::setw(9)
+                          << fp_operand_class_names[ca] << std::setw(9) << fp_operand_class_names[cb] << std::right
+                          << std::setw(10) << n << "\n";
+                total += n;
+            }
+    std::cout << total << " of " << in.count() << " vectors\n";
+    return 0;
+}
+
+static void write_vectors_json(std::ostream& os, uint64_t count, const VectorDriver& d, double secs) {
+    double s = secs > 0 ? secs : 1e-9;
+    os << std::dec;
+    os << "{\"model\": \"pipelined-execute\""
+       << ", \"vectors\": " << count
+       << ", \"passed\": " << d.passed
+       << ", \"failed\": " << d.failed
+       << ", \"unchecked\": " << d.unchecked
+       << ", \"cycles\": " << d.cycles
+       << ", \"vectors_per_cycle\": " << (d.cycles ? (double)count / d.cycles : 0.0)
+       << ", \"wall_seconds\": " << secs
+       << ", \"vectors_per_second\": " << count / s
+       << ", \"peak_rss_kb\": " << bench_peak_rss_kb() << "}\n";
+}
+
+int sc_main(int argc, char* argv[]) {
+    vectors_options opt;
+    if (!parse_vectors_args(argc, argv, opt)) return 1;
+    if (opt.generate) return generate_vectors(opt);
+    if (!opt.import.empty()) return import_vectors(opt);
+    if (!opt.export_hex.empty()) return export_hex(opt);
+    if (opt.info) return vector_info(opt);
+
+    std::string error;
+    fpu_vector_map in, out;
+    if (!in.open_vectors(opt.vectors, error)) { std::cerr << error << "\n"; return 1; }
+    uint64_t n = in.count();
+    // The vector index travels as the 32-bit pc
+    if (n > UINT32_MAX) { std::cerr << opt.vectors << ": 2^32 vectors or more\n"; return 1; }
+    if (!out.create_results(opt.results, n, error)) { std::cerr << error << "\n"; return 1; }
+
+    sc_clock clk("clk", 10, SC_NS);
+    sc_signal<bool> reset;
+    sc_signal<bool> stall;
+    sc_signal<decode_to_execute_t> to_execute;
+    sc_signal<execute_to_wb_t>     from_execute;
+    sc_signal<sc_uint<3>>          div_busy;
+    sc_signal<bool>                div_dropped, div_late;
+
+    Execute execute("execute");
+    execute.clk(clk);
+    execute.reset(reset);
+    execute.stall(stall);
+    execute.in(to_execute);
+    execute.out(from_execute);
+    execute.div_busy_out(div_busy);
+    execute.div_dropped_out(div_dropped);
+    execute.div_late_out(div_late);
+
+    VectorDriver driver("driver");
+    driver.clk(clk);
+    driver.reset(reset);
+    driver.out(to_execute);
+    driver.in(from_execute);
+    driver.div_dropped_in(div_dropped);
+    driver.bind(in.vectors(), out.results(), n);
+
+    reset.write(true);
+    stall.write(false);
+    sc_start(25, SC_NS);
+    reset.write(false);
+
+    bench_timer timer;
+    sc_start();
+    double secs = timer.seconds();
+
+    const fpu_vector_t*        v = in.vectors();
+    const fpu_vector_result_t* r = out.results();
+    unsigned shown = 0;
+    for (uint64_t i = 0; i < n && shown < opt.show && driver.failed; ++i) {
+        if (r[i].status != FPU_VECTOR_FAIL) continue;
+        std::cerr << "vector " << i << ": op " << (int)v[i].opcode << std::hex << std::setfill('0')
+                  << " a 0x" << std::setw(8) << v[i].a << " b 0x" << std::setw(8) << v[i].b
+                  << " expected 0x" << std::setw(8) << v[i].expected << "/" << std::setw(2) << (int)v[i].expected_exceptions
+                  << " got 0x" << std::setw(8) << r[i].result << "/" << std::setw(2) << (int)r[i].exceptions
+                  << std::dec << std::setfill(' ') << "\n";
+        ++shown;
+    }
+
+    if (opt.json.empty()) {
+        write_vectors_json(std::cout, n, driver, secs);
+    } else {
+        std::ofstream js(opt.json.c_str(), std::ios::app);
+        write_vectors_json(js, n, driver, secs);
+    }
+    return driver.failed || !driver.done() ? 1 : 0;
+}
@@ -0,0 +1,217 @@
+#ifndef FPU_COMMIT_LOG_H
+#define FPU_COMMIT_LOG_H
+
+// Commit log in the format of `spike --isa=rv32f --log-commits`, one line
+// per retired instruction:
+//   core   0: 3 0x80000004 (0x00208053) f0  0x40400000 c1_fflags 0x00000001
+// The c1_fflags write is present when the instruction raised a flag and
+// holds the accrued value, as Spike logs it. Flags are in RISC-V fflags
+// order (NV DZ OF UF NX); each core remaps its own exception bits.
+// Lines come out in program order: a core that writes back out of order
+// numbers its instructions with issue() and announces a late one with
+// expect(), and younger commits are held until it commits. replay() logs
+// a repeated write on a line the parser skips. The parser below is
+// shared with src/Tools/commit_diff.cpp.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <set>
+
+enum riscv_fflags {
+    FFLAGS_NX = 0x01,
+    FFLAGS_UF = 0x02,
+    FFLAGS_OF = 0x04,
+    FFLAGS_DZ = 0x08,
+    FFLAGS_NV = 0x10
+};
+
+// Spike's default reset vector, where its programs start
+static const uint32_t COMMIT_LOG_PC_BASE = 0x80000000u;
+
+class CommitLog {
+public:
+    static bool start(const char* path, uint32_t pc_base = COMMIT_LOG_PC_BASE) {
+        if (s_active) return false;
+        FILE* f = std::fopen(path, "w");
+        if (!f) return false;
+        s_active = new CommitLog(f, pc_base);
+        return true;
+    }
+
+    static void stop() {
+        delete s_active;
+        s_active = nullptr;
+    }
+
+    static CommitLog* active() { return s_active; }
+
+    // For cores whose writeback does not carry the instruction word;
+    // pc is the core's own byte address
+    void set_insn_lookup(std::function<uint32_t(uint32_t)> f) { insn_at = f; }
+
+    // Issue order, by PC: PCs repeat when a program loops, but never
+    // within the few instructions in flight
+    void issue(uint32_t pc) { seq_of[pc] = next_seq++; }
+
+    // The instruction at pc will commit after younger ones (a division
+    // left in a divider slot); their commits wait until it does
+    void expect(uint32_t pc) {
+        auto it = seq_of.find(pc);
+        if (it != seq_of.end()) late.insert(it->second);
+    }
+
+    void commit(uint32_t pc, uint32_t insn, unsigned rd, uint32_t value, uint32_t raised_fflags) {
+        if (insn_at) insn = insn_at(pc);
+        auto it = seq_of.find(pc);
+        if (it != seq_of.end()) {
+            uint64_t seq = it->second;
+            seq_of.erase(it);
+            late.erase(seq);
+            if (!late.empty() && seq > *late.begin()) {
+                held[seq] = held_t{pc, insn, rd, value, raised_fflags};
+                return;
+            }
+        }
+        write(pc, insn, rd, value, raised_fflags);
+        release();
+    }
+
+    // A second write for an instruction already committed, e.g. the
+    // non-pipelined core issuing its first word twice. Logged for reading
+    // but without the "core" prefix, so commit_log_parse() skips it.
+    void replay(uint32_t pc, uint32_t insn, unsigned rd, uint32_t value) {
+        if (insn_at) insn = insn_at(pc);
+        std::fprintf(file, "replay     0x%08x (0x%08x) f%-2u 0x%08x\n", pc_base + pc, insn, rd, value);
+    }
+
+    uint64_t count() const { return commits; }
+
+private:
+    struct held_t {
+        uint32_t pc;
+        uint32_t insn;
+        unsigned rd;
+        uint32_t value;
+        uint32_t raised_fflags;
+    };
+
+    CommitLog(FILE* f, uint32_t base) : file(f), pc_base(base), fflags(0), commits(0), next_seq(0) {
+        std::setvbuf(file, nullptr, _IOFBF, 1 << 20);
+    }
+    ~CommitLog() {
+        // Whatever is still held waits for a division that never finished
+        late.clear();
+        release();
+        std::fclose(file);
+    }
+
+    void write(uint32_t pc, uint32_t insn, unsigned rd, uint32_t value, uint32_t raised_fflags) {
+        std::fprintf(file, "core   0: 3 0x%08x (0x%08x) f%-2u 0x%08x", pc_base + pc, insn, rd, value);
+        if (raised_fflags) {
+            fflags |= raised_fflags & 0x1F;
+            std::fprintf(file, " c1_fflags 0x%08x", fflags);
+        }
+        std::fputc('\n', file);
+        ++commits;
+    }
+
+    // Writes the held commits older than the oldest late instruction
+    void release() {
+        while (!held.empty() && (late.empty() || held.begin()->first < *late.begin())) {
+            const held_t& h = held.begin()->second;
+            write(h.pc, h.insn, h.rd, h.value, h.raised_fflags);
+            held.erase(held.begin());
+        }
+    }
+
+    FILE*                              file;
+    uint32_t                           pc_base;
+    uint32_t                           fflags;
+    uint64_t                           commits;
+    std::function<uint32_t(uint32_t)>  insn_at;
+    uint64_t                           next_seq;
+    std::map<uint32_t, uint64_t>       seq_of;
+    std::set<uint64_t>                 late;
+    std::map<uint64_t, held_t>         held;
+
+    static inline CommitLog* s_active = nullptr;
+};
+
+// One parsed commit line. Register writes are kept as written; Spike does
+// not order them, so comparisons go through commit_record_t::find().
+struct commit_record_t {
+    static const int MAX_WRITES = 8;
+
+    uint64_t pc;
+    uint32_t insn;
+    int      num_writes;
+    char     name[MAX_WRITES][16];   // "f3", "x10", "c1_fflags", "mem", ...
+    uint64_t value[MAX_WRITES];
+
+    int find(const char* n) const {
+        for (int i = 0; i < num_writes; ++i)
+            if (std::strcmp(name[i], n) == 0) return i;
+        return -1;
+    }
+    bool writes_fp() const {
+        for (int i = 0; i < num_writes; ++i)
+            if (name[i][0] == 'f' && name[i][1] >= '0' && name[i][1] <= '9') return true;
+        return false;
+    }
+};
+
+// Parses a --log-commits line; false for anything else (disassembly lines
+// from -l, banners, ...). Instructions without writes (stores, branches)
+// parse with num_writes == 0. Memory accesses ("mem 0xADDR [0xVALUE]") are
+// kept as a single "mem" write of the address.
+static inline bool commit_log_parse(const char* line, commit_record_t& r) {
+    const char* p = std::strstr(line, "core");
+    if (!p || !(p = std::strchr(p, ':'))) return false;
+    char* end;
+    ++p;
+    while (*p == ' ') ++p;
+    // Commit lines carry the privilege level, disassembly lines from -l do not
+    bool priv = p[0] >= '0' && p[0] <= '9' && p[1] == ' ';
+    if (priv) p += 2;
+    while (*p == ' ') ++p;
+    if (p[0] != '0' || p[1] != 'x') return false;
+    r.pc = std::strtoull(p, &end, 16);
+    p = end;
+    while (*p == ' ') ++p;
+    if (p[0] != '(') return false;
+    r.insn = (uint32_t)std::strtoul(p + 1, &end, 16);
+    p = *end == ')' ? end + 1 : end;
+
+    r.num_writes = 0;
+    while (true) {
+        while (*p == ' ' || *p == '\t') ++p;
+        if (!*p || *p == '\n' || *p == '\r') break;
+        const char* tok = p;
+        while (*p && *p != ' ' && *p != '\t' && *p != '\n' && *p != '\r') ++p;
+        size_t len = (size_t)(p - tok);
+        if (len == 0 || tok[0] == '0') return false;
+        while (*p == ' ') ++p;
+        if (p[0] != '0' || p[1] != 'x') return false;
+        uint64_t v = std::strtoull(p, &end, 16);
+        p = end;
+        if (len == 3 && std::strncmp(tok, "mem", 3) == 0) {
+            while (*p == ' ') ++p;
+            if (p[0] == '0' && p[1] == 'x') {   // store data
+                std::strtoull(p, &end, 16);
+                p = end;
+            }
+        }
+        if (r.num_writes == commit_record_t::MAX_WRITES) continue;
+        if (len >= sizeof(r.name[0])) len = sizeof(r.name[0]) - 1;
+        std::memcpy(r.name[r.num_writes], tok, len);
+        r.name[r.num_writes][len] = 0;
+        r.value[r.num_writes++] = v;
+    }
+    return priv;
+}
+
+#endif // FPU_COMMIT_LOG_H
@@ -0,0 +1,202 @@
+#ifndef FPU_SIM_LOG_H
+#define FPU_SIM_LOG_H
+
+// Levelled, per-category simulation log. FPU_LOG() packs a record (time,
+// category, level, format literal, up to six integer arguments) into a
+// lock-free ring; a background thread formats the records and writes lines
+//   IFU @20 ns: PC=0x4 Instruction=0x00208053
+// to a FILE, so the kernel thread never formats or does I/O.
+//
+// Two filters:
+//   compile time  -DFPU_LOG_LEVEL=N keeps calls up to level N (default all);
+//                 0 removes every call and its argument evaluation
+//   run time      SimLog::start() takes a level and a category mask; until
+//                 it is called, a call costs one pointer test
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <strings.h>
+#include <thread>
+#include <systemc.h>
+#include "spsc_ring.h"
+
+enum sim_log_level {
+    SIMLOG_OFF = 0,
+    SIMLOG_ERROR,
+    SIMLOG_INFO,      // once per run (final register dump)
+    SIMLOG_DEBUG,
+    SIMLOG_TRACE      // once per stage per instruction
+};
+
+enum sim_log_category {
+    SIMLOG_IFU = 0,
+    SIMLOG_DEC,
+    SIMLOG_EXE,
+    SIMLOG_MEM,
+    SIMLOG_WB,
+    SIMLOG_REG,
+    SIMLOG_SIM,       // not tied to a stage
+    SIMLOG_CATEGORY_NUM
+};
+
+static const char* const sim_log_category_names[SIMLOG_CATEGORY_NUM] = {
+    "IFU", "DEC", "EXE", "MEM", "WB", "REG", "SIM"
+};
+
+static const uint32_t SIMLOG_ALL = (1u << SIMLOG_CATEGORY_NUM) - 1;
+
+#ifndef FPU_LOG_LEVEL
+#define FPU_LOG_LEVEL 4   // SIMLOG_TRACE
+#endif
+
+struct sim_log_record_t {
+    uint64_t    time;      // sc_time_stamp().value()
+    const char* fmt;       // printf format with %u/%x conversions, a string literal
+    uint32_t    arg[6];
+    uint8_t     category;
+    uint8_t     level;
+};
+
+class SimLog {
+public:
+    // Logs to f (not closed by stop()) from now on
+    static bool start(FILE* f, unsigned level = SIMLOG_TRACE, uint32_t categories = SIMLOG_ALL,
+                      size_t capacity = 1 << 16) {
+        if (s_active) return false;
+        s_active = new SimLog(f, false, level, categories, capacity);
+        return true;
+    }
+    static bool start(const char* path, unsigned level = SIMLOG_TRACE, uint32_t categories = SIMLOG_ALL,
+                      size_t capacity = 1 << 16) {
+        if (s_active) return false;
+        FILE* f = std::fopen(path, "w");
+        if (!f) return false;
+        s_active = new SimLog(f, true, level, categories, capacity);
+        return true;
+    }
+
+    // Drains the ring and returns the number of records written
+    static uint64_t stop() {
+        if (!s_active) return 0;
+        uint64_t n = s_active->recorded;
+        delete s_active;
+        s_active = nullptr;
+        return n;
+    }
+
+    // Waits until every record so far is written, so that direct output to
+    // the same stream comes after them
+    static void flush() {
+        if (!s_active) return;
+        while (s_active->written.load(std::memory_order_acquire) != s_active->recorded) std::this_thread::yield();
+        std::fflush(s_active->file);
+    }
+
+    static SimLog* active() { return s_active; }
+
+    static bool wants(unsigned category, unsigned level) {
+        return s_active && level <= s_active->level && (s_active->categories >> category & 1);
+    }
+
+    template <class... A>
+    void record(unsigned category, unsigned level, const char* fmt, const A&... args) {
+        static_assert(sizeof...(A) <= 6, "FPU_LOG takes at most six arguments");
+        sim_log_record_t r;
+        r.time     = sc_time_stamp().value();
+        r.fmt      = fmt;
+        uint32_t v[6] = {(uint32_t)(uint64_t)args...};
+        std::memcpy(r.arg, v, sizeof(v));
+        r.category = (uint8_t)category;
+        r.level    = (uint8_t)level;
+        // Ring full: the writer is behind, wait instead of losing records
+        while (!ring.try_push(r)) std::this_thread::yield();
+        ++recorded;
+    }
+
+private:
+    SimLog(FILE* f, bool owned, unsigned level, uint32_t categories, size_t capacity)
+        : file(f), owned(owned), level(level), categories(categories), ring(capacity), done(false),
+          recorded(0), written(0), tick_ns(sc_get_time_resolution().to_seconds() * 1e9) {
+        writer = std::thread(&SimLog::flush_loop, this);
+    }
+
+    ~SimLog() {
+        done.store(true, std::memory_order_release);
+        writer.join();
+        if (owned) std::fclose(file);
+        else std::fflush(file);
+    }
+
+    void format(const sim_log_record_t& r) {
+        std::fprintf(file, "%-3s @%.15g ns: ", sim_log_category_names[r.category], (double)r.time * tick_ns);
+        std::fprintf(file, r.fmt, r.arg[0], r.arg[1], r.arg[2], r.arg[3], r.arg[4], r.arg[5]);
+        std::fputc('\n', file);
+    }
+
+    void flush_loop() {
+        for (;;) {
+            bool last = done.load(std::memory_order_acquire);
+            const sim_log_record_t* p;
+            size_t n;
+            bool wrote = false;
+            while ((n = ring.peek(&p)) != 0) {
+                for (size_t i = 0; i < n; ++i) format(p[i]);
+                ring.consume(n);
+                written.fetch_add(n, std::memory_order_release);
+                wrote = true;
+            }
+            if (last) break;
+            if (!wrote) std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+
+    FILE*                         file;
+    bool                          owned;
+    unsigned                      level;
+    uint32_t                      categories;
+    spsc_ring<sim_log_record_t>   ring;
+    std::atomic<bool>             done;
+    uint64_t                      recorded;
+    std::atomic<uint64_t>         written;
+    double                        tick_ns;
+    std::thread                   writer;
+
+    static inline SimLog* s_active = nullptr;
+};
+
+// "ifu,dec,wb" -> category mask; "all" for every category. 0 on an unknown name.
+static inline uint32_t sim_log_parse_categories(const char* list) {
+    uint32_t mask = 0;
+    while (*list) {
+        const char* end = std::strchr(list, ',');
+        size_t len = end ? (size_t)(end - list) : std::strlen(list);
+        bool found = len == 3 && strncasecmp(list, "all", 3) == 0;
+        if (found) mask = SIMLOG_ALL;
+        for (int c = 0; c < SIMLOG_CATEGORY_NUM && !found; ++c) {
+            if (std::strlen(sim_log_category_names[c]) == len && strncasecmp(list, sim_log_category_names[c], len) == 0) {
+                mask |= 1u << c;
+                found = true;
+            }
+        }
+        if (!found) return 0;
+        list += len;
+        if (*list == ',') ++list;
+    }
+    return mask;
+}
+
+#if FPU_LOG_LEVEL > 0
+#define FPU_LOG(category, level, ...)                                                \
+    do {                                                                             \
+        if ((level) <= FPU_LOG_LEVEL && SimLog::wants((category), (level)))          \
+            SimLog::active()->record((category), (level), __VA_ARGS__);              \
+    } while (0)
+#else
+#define FPU_LOG(category, level, ...) do {} while (0)
+#endif
+
+#endif // FPU_SIM_LOG_H
@@ -0,0 +1,70 @@
+#ifndef FPU_SPSC_RING_H
+#define FPU_SPSC_RING_H
+
+// Single-producer / single-consumer lock-free ring buffer.
+// The SystemC kernel thread produces, a background thread consumes.
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+template <class T>
+class spsc_ring {
+public:
+    // capacity is rounded up to a power of two
+    explicit spsc_ring(size_t capacity) {
+        size_t n = 1;
+        while (n < capacity) n <<= 1;
+        buf.resize(n);
+        mask = n - 1;
+    }
+
+    bool try_push(const T& v) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) > mask) return false;
+        buf[h & mask] = v;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Pushes up to n values with one pair of atomic operations; returns how
+    // many fitted
+    size_t try_push_n(const T* v, size_t n) {
+        size_t h = head.load(std::memory_order_relaxed);
+        size_t room = buf.size() - (h - tail.load(std::memory_order_acquire));
+        if (n > room) n = room;
+        for (size_t i = 0; i < n; ++i) buf[(h + i) & mask] = v[i];
+        head.store(h + n, std::memory_order_release);
+        return n;
+    }
+
+    bool try_pop(T& v) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) return false;
+        v = buf[t & mask];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: largest contiguous readable block, release with consume()
+    size_t peek(const T** first) const {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t n = head.load(std::memory_order_acquire) - t;
+        size_t to_end = buf.size() - (t & mask);
+        *first = &buf[t & mask];
+        return n < to_end ? n : to_end;
+    }
+    void consume(size_t n) { tail.store(tail.load(std::memory_order_relaxed) + n, std::memory_order_release); }
+
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+private:
+    std::vector<T> buf;
+    size_t mask;
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+};
+
+#endif // FPU_SPSC_RING_H
@@ -0,0 +1,521 @@
+#ifndef FPU_FARM_H
+#define FPU_FARM_H
+
+// Multi-process scenario farm. The SystemC kernel can elaborate one design
+// per process, so every scenario runs in its own forked worker. Up to -j
+// workers run at once. Program images are mmapped read-only by the parent
+// before forking, so all workers share the same pages. Each worker writes
+// its result into a slot of a shared anonymous mapping, and the parent
+// aggregates pass/fail, counters and timing into one report.
+//
+// Manifest: one scenario per line, whitespace-separated key=value pairs,
+// '#' starts a comment. Paths are relative to the manifest.
+//   name=fadd_basic image=fadd_basic.img cycles=2000 expect=f3:0x40B7E151
+//
+// Image: fpu_image_header_t, then num_words little-endian instruction words
+// encoded for the model the farm binary was built for.
+//
+// Writeback stream: every register write in program order, one "fN 0xVALUE"
+// line. --retire-log DIR writes DIR/<name>.wb per scenario; --reference DIR
+// checks each write against the stream another model wrote for the same
+// image (e.g. the Verilated FPU.sv against the SystemC non-pipelined core).
+//
+// --sv-tests DIR turns every passing scenario of an RV32F model into test
+// files for the self-checking SystemVerilog testbench
+// (src/Testbench/fpu_selfcheck_tb.sv): DIR/<name>.prog.hex, the initial
+// registers at @0 and the program at @20, DIR/<name>.expect.hex, the final
+// registers, and DIR/tests.txt listing them. Generate with --length below
+// the memory size so every program ends in a zero word.
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "bench_common.h"
+
+static const char     FPU_IMAGE_MAGIC[8] = {'F', 'P', 'U', 'I', 'M', 'G', 0, 0};
+static const uint32_t FPU_IMAGE_VERSION  = 1;
+
+struct fpu_image_header_t {
+    char     magic[8];
+    uint32_t version;
+    uint32_t num_words;
+    uint32_t regs[32];      // initial register file
+};
+
+// Read-only view into an mmapped image
+struct fpu_image_view {
+    const fpu_image_header_t* header;
+    const uint32_t*           words;
+};
+
+static const int FARM_MAX_COUNTERS = 24;
+
+enum farm_status { FARM_PENDING = 0, FARM_PASS, FARM_FAIL, FARM_CRASH, FARM_TIMEOUT };
+static const char* const farm_status_names[] = {"pending", "pass", "fail", "crash", "timeout"};
+
+// Lives in shared memory, written by the worker
+struct farm_result_t {
+    int      status;
+    uint64_t cycles;
+    uint64_t retired;
+    uint64_t counters[FARM_MAX_COUNTERS];
+    double   wall_seconds;
+    char     message[120];
+    uint32_t regs[32];          // final register file
+};
+
+struct farm_expect_t {
+    unsigned reg;
+    uint32_t value;
+};
+
+struct farm_scenario_t {
+    std::string                name;
+    std::string                image;
+    uint64_t                   cycles = 2000;
+    std::vector<farm_expect_t> expects;
+};
+
+// What a farm binary provides for its model
+struct farm_model_t {
+    const char*        name;
+    int                num_counters;
+    const char* const* counter_names;
+    // Runs in the worker; fills r (status, cycles, counters, message)
+    void (*run)(const farm_scenario_t& s, const fpu_image_view& img, farm_result_t& r);
+    uint32_t (*encode)(const bench_inst_t& i);
+    unsigned max_words;
+    bool     rv32f_images = false;   // images are RV32F OP-FP words (FPU.sv's encoding)
+};
+
+static inline bool farm_write_image(const std::string& path, const uint32_t regs[32], const std::vector<uint32_t>& words) {
+    fpu_image_header_t h;
+    std::memcpy(h.magic, FPU_IMAGE_MAGIC, sizeof(h.magic));
+    h.version   = FPU_IMAGE_VERSION;
+    h.num_words = (uint32_t)words.size();
+    std::memcpy(h.regs, regs, sizeof(h.regs));
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(&h, sizeof(h), 1, f) == 1 &&
+              std::fwrite(words.data(), sizeof(uint32_t), words.size(), f) == words.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+// Maps an image read-only; the mapping is inherited by every worker
+static inline bool farm_map_image(const std::string& path, fpu_image_view& view, std::string& error) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) { error = "cannot open " + path; return false; }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(fpu_image_header_t)) {
+        close(fd);
+        error = path + ": not an FPU image";
+        return false;
+    }
+    void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) { error = "cannot mmap " + path; return false; }
+
+    const fpu_image_header_t* h = static_cast<const fpu_image_header_t*>(p);
+    if (std::memcmp(h->magic, FPU_IMAGE_MAGIC, sizeof(h->magic)) != 0 || h->version != FPU_IMAGE_VERSION ||
+        sizeof(*h) + (size_t)h->num_words * sizeof(uint32_t) > (size_t)st.st_size) {
+        munmap(p, st.st_size);
+        error = path + ": not a version " + std::to_string(FPU_IMAGE_VERSION) + " FPU image";
+        return false;
+    }
+    view.header = h;
+    view.words  = reinterpret_cast<const uint32_t*>(h + 1);
+    return true;
+}
+
+static inline std::string farm_dirname(const std::string& path) {
+    size_t p = path.rfind('/');
+    return p == std::string::npos ? std::string(".") : path.substr(0, p);
+}
+
+static inline bool farm_parse_manifest(const std::string& path, std::vector<farm_scenario_t>& out, std::string& error) {
+    std::ifstream in(path.c_str());
+    if (!in) { error = "cannot open " + path; return false; }
+    std::string dir = farm_dirname(path), line;
+    for (int lineno = 1; std::getline(in, line); ++lineno) {
+        size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+        std::istringstream ss(line);
+        std::string kv;
+        farm_scenario_t s;
+        bool any = false;
+        while (ss >> kv) {
+            any = true;
+            size_t eq = kv.find('=');
+            std::string key = kv.substr(0, eq), val = eq == std::string::npos ? "" : kv.substr(eq + 1);
+            if (key == "name") s.name = val;
+            else if (key == "image") s.image = val[0] == '/' ? val : dir + "/" + val;
+            else if (key == "cycles") s.cycles = std::strtoull(val.c_str(), nullptr, 0);
+            else if (key == "expect" && val.size() > 1 && val[0] == 'f' && val.find(':') != std::string::npos) {
+                farm_expect_t e;
+                e.reg   = (unsigned)std::strtoul(val.c_str() + 1, nullptr, 10);
+                e.value = (uint32_t)std::strtoul(val.c_str() + val.find(':') + 1, nullptr, 0);
+                if (e.reg >= 32) { error = path + ":" + std::to_string(lineno) + ": bad register"; return false; }
+                s.expects.push_back(e);
+            } else {
+                error = path + ":" + std::to_string(lineno) + ": unknown field '" + kv + "'";
+                return false;
+            }
+        }
+        if (!any) continue;
+        if (s.image.empty()) { error = path + ":" + std::to_string(lineno) + ": missing image="; return false; }
+        if (s.name.empty()) s.name = "line" + std::to_string(lineno);
+        out.push_back(s);
+    }
+    return true;
+}
+
+// Worker helper: compares the final register file against expect= entries
+// and keeps it for --sv-tests
+static inline void farm_check_expects(const farm_scenario_t& s, const uint32_t regs[32], farm_result_t& r) {
+    std::memcpy(r.regs, regs, sizeof(r.regs));
+    r.status = FARM_PASS;
+    for (const farm_expect_t& e : s.expects) {
+        if (regs[e.reg] != e.value) {
+            r.status = FARM_FAIL;
+            std::snprintf(r.message, sizeof(r.message), "f%u = 0x%08x, expected 0x%08x", e.reg, regs[e.reg], e.value);
+            return;
+        }
+    }
+}
+
+// Worker-side writeback stream state, see the header comment
+struct farm_retire_stream_t {
+    FILE*                                      log = nullptr;
+    bool                                       checking = false;
+    std::vector<std::pair<unsigned, uint32_t>> reference;
+    size_t                                     count = 0;
+    std::string                                mismatch;
+};
+
+static inline farm_retire_stream_t& farm_retire_stream() {
+    static farm_retire_stream_t s;
+    return s;
+}
+
+static inline bool farm_retire_begin(const std::string& log_dir, const std::string& ref_dir,
+                                     const farm_scenario_t& s, std::string& error) {
+    farm_retire_stream_t& st = farm_retire_stream();
+    if (!log_dir.empty()) {
+        std::string path = log_dir + "/" + s.name + ".wb";
+        if (!(st.log = std::fopen(path.c_str(), "w"))) { error = "cannot write " + path; return false; }
+    }
+    if (!ref_dir.empty()) {
+        std::string path = ref_dir + "/" + s.name + ".wb";
+        FILE* f = std::fopen(path.c_str(), "r");
+        if (!f) { error = "no reference stream " + path; return false; }
+        unsigned rd, value;
+        while (std::fscanf(f, " f%u 0x%x", &rd, &value) == 2) st.reference.push_back(std::make_pair(rd, (uint32_t)value));
+        std::fclose(f);
+        st.checking = true;
+    }
+    return true;
+}
+
+// Called by the model for every register-file write, in program order
+static inline void farm_retire(unsigned rd, uint32_t value) {
+    farm_retire_stream_t& st = farm_retire_stream();
+    if (st.log) std::fprintf(st.log, "f%u 0x%08x\n", rd, value);
+    // Both models drain before they stop, so the streams have the same length
+    if (st.checking && st.mismatch.empty()) {
+        char buf[120];
+        if (st.count >= st.reference.size()) {
+            std::snprintf(buf, sizeof(buf), "write %zu: f%u = 0x%08x, past the reference's %zu writes", st.count, rd,
+                          value, st.reference.size());
+            st.mismatch = buf;
+        } else {
+            const std::pair<unsigned, uint32_t>& ref = st.reference[st.count];
+            if (ref.first != rd || ref.second != value) {
+                std::snprintf(buf, sizeof(buf), "write %zu: f%u = 0x%08x, reference f%u = 0x%08x", st.count, rd,
+                              value, ref.first, ref.second);
+                st.mismatch = buf;
+            }
+        }
+    }
+    ++st.count;
+}
+
+// A reference mismatch overrides the model's own verdict
+static inline void farm_retire_end(farm_result_t& r) {
+    farm_retire_stream_t& st = farm_retire_stream();
+    if (st.log) std::fclose(st.log);
+    st.log = nullptr;
+    if (!st.checking) return;
+    if (st.mismatch.empty() && st.count < st.reference.size()) {
+        char buf[120];
+        std::snprintf(buf, sizeof(buf), "%zu writes, reference has %zu", st.count, st.reference.size());
+        st.mismatch = buf;
+    }
+    if (!st.mismatch.empty()) {
+        r.status = FARM_FAIL;
+        std::snprintf(r.message, sizeof(r.message), "%s", st.mismatch.c_str());
+    }
+}
+
+// Writes COUNT random scenarios (all benchmark mixes, round robin) into dir.
+// length 0 fills the instruction memory.
+static inline int farm_generate(const farm_model_t& model, const std::string& dir, int count, uint64_t cycles,
+                                unsigned length) {
+    std::ofstream manifest((dir + "/manifest.txt").c_str());
+    if (!manifest) { std::cerr << "cannot write " << dir << "/manifest.txt\n"; return 1; }
+    size_t nmix = sizeof(bench_mixes) / sizeof(bench_mixes[0]);
+    for (int i = 0; i < count; ++i) {
+        const bench_mix_t& mix = bench_mixes[i % nmix];
+        int words_per_program = (int)(length && length < model.max_words ? length : model.max_words);
+        std::vector<bench_inst_t> prog = make_bench_program(mix, words_per_program, (uint32_t)(i + 1));
+        std::vector<uint32_t> words;
+        for (const bench_inst_t& in : prog) words.push_back(model.encode(in));
+        uint32_t regs[32];
+        bench_seed_registers(mix, regs);
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "s%04d_%s", i, mix.name);
+        if (!farm_write_image(dir + "/" + name + ".img", regs, words)) {
+            std::cerr << "cannot write " << dir << "/" << name << ".img\n";
+            return 1;
+        }
+        manifest << "name=" << name << " image=" << name << ".img cycles=" << cycles << "\n";
+    }
+    std::cerr << "wrote " << count << " scenarios to " << dir << "/manifest.txt\n";
+    return 0;
+}
+
+struct farm_options {
+    std::string manifest;
+    std::string json;
+    int         jobs    = 0;     // 0: one per online CPU
+    double      timeout = 0;     // seconds per scenario, 0 = none
+    bool        verbose = false;
+    std::string retire_log;      // directory for <name>.wb writeback streams
+    std::string reference;       // directory of streams to check against
+    std::string sv_tests;        // directory for SystemVerilog testbench files
+    std::string gen_dir;
+    int         gen_count  = 0;
+    uint64_t    gen_cycles = 2000;
+    unsigned    gen_length = 0;  // 0: fill the instruction memory
+};
+
+static inline void farm_usage(const char* prog) {
+    std::cerr << "usage: " << prog << " [-j N] [--timeout SEC] [--json FILE] [--verbose]\n"
+              << "       [--retire-log DIR] [--reference DIR] [--sv-tests DIR] MANIFEST\n"
+              << "       " << prog << " --generate DIR COUNT [--cycles N] [--length WORDS]\n";
+}
+
+static inline bool parse_farm_args(int argc, char* argv[], farm_options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        bool has_val = i + 1 < argc;
+        if (a == "-j" && has_val) opt.jobs = std::atoi(argv[++i]);
+        else if (a == "--timeout" && has_val) opt.timeout = std::atof(argv[++i]);
+        else if (a == "--json" && has_val) opt.json = argv[++i];
+        else if (a == "--verbose") opt.verbose = true;
+        else if (a == "--retire-log" && has_val) opt.retire_log = argv[++i];
+        else if (a == "--reference" && has_val) opt.reference = argv[++i];
+        else if (a == "--sv-tests" && has_val) opt.sv_tests = argv[++i];
+        else if (a == "--generate" && i + 2 < argc) { opt.gen_dir = argv[++i]; opt.gen_count = std::atoi(argv[++i]); }
+        else if (a == "--cycles" && has_val) opt.gen_cycles = std::strtoull(argv[++i], nullptr, 0);
+        else if (a == "--length" && has_val) opt.gen_length = (unsigned)std::strtoul(argv[++i], nullptr, 0);
+        else if (opt.manifest.empty() && a[0] != '-') opt.manifest = a;
+        else { farm_usage(argv[0]); return false; }
+    }
+    if (opt.gen_dir.empty() == opt.manifest.empty()) { farm_usage(argv[0]); return false; }
+    return true;
+}
+
+static inline void farm_report(std::ostream& os, const farm_model_t& model, const std::vector<farm_scenario_t>& sc,
+                               const farm_result_t* res, int jobs, double wall, bool verbose) {
+    int count[5] = {0, 0, 0, 0, 0};
+    uint64_t cycles = 0, retired = 0, counters[FARM_MAX_COUNTERS] = {0};
+    double cpu = 0;
+    for (size_t i = 0; i < sc.size(); ++i) {
+        const farm_result_t& r = res[i];
+        ++count[r.status];
+        cycles += r.cycles;
+        retired += r.retired;
+        cpu += r.wall_seconds;
+        for (int c = 0; c < model.num_counters; ++c) counters[c] += r.counters[c];
+        if (verbose || (r.status != FARM_PASS))
+            os << std::left << std::setw(8) << farm_status_names[r.status] << std::right << " " << sc[i].name
+               << (r.message[0] ? "  (" : "") << r.message << (r.message[0] ? ")" : "") << "\n";
+    }
+    os << std::dec << "\n--- " << model.name << " farm: " << sc.size() << " scenarios, " << jobs << " workers ---\n"
+       << "pass " << count[FARM_PASS] << "  fail " << count[FARM_FAIL] << "  crash " << count[FARM_CRASH]
+       << "  timeout " << count[FARM_TIMEOUT] << "\n"
+       << "simulated cycles       " << cycles << "\n"
+       << "retired                " << retired << "\n"
+       << "wall seconds           " << wall << "\n"
+       << "worker seconds         " << cpu << "  (speedup " << (wall > 0 ? cpu / wall : 0.0) << "x)\n";
+    for (int c = 0; c < model.num_counters; ++c)
+        os << std::left << std::setw(23) << model.counter_names[c] << std::right << counters[c] << "\n";
+}
+
+static inline void farm_write_json(std::ostream& os, const farm_model_t& model, const std::vector<farm_scenario_t>& sc,
+                                   const farm_result_t* res, double wall) {
+    os << std::dec << "{\"model\": \"" << model.name << "\", \"wall_seconds\": " << wall << ", \"scenarios\": [\n";
+    for (size_t i = 0; i < sc.size(); ++i) {
+        const farm_result_t& r = res[i];
+        os << "  {\"name\": \"" << sc[i].name << "\", \"status\": \"" << farm_status_names[r.status]
+           << "\", \"cycles\": " << r.cycles << ", \"retired\": " << r.retired
+           << ", \"wall_seconds\": " << r.wall_seconds << ", \"message\": \"" << r.message << "\"";
+        for (int c = 0; c < model.num_counters; ++c) os << ", \"" << model.counter_names[c] << "\": " << r.counters[c];
+        os << "}" << (i + 1 < sc.size() ? ",\n" : "\n");
+    }
+    os << "]}\n";
+}
+
+// --sv-tests: see the header comment. MAX_CYCLES in tests.txt is the
+// scenario's cycle budget.
+static inline bool farm_write_sv_tests(const std::string& dir, const std::vector<farm_scenario_t>& sc,
+                                       std::map<std::string, fpu_image_view>& images, const farm_result_t* res) {
+    std::ofstream list((dir + "/tests.txt").c_str());
+    if (!list) { std::cerr << "cannot write " << dir << "/tests.txt\n"; return false; }
+    size_t written = 0;
+    for (size_t i = 0; i < sc.size(); ++i) {
+        if (res[i].status != FARM_PASS) continue;
+        const fpu_image_view& img = images[sc[i].image];
+        std::string prog = sc[i].name + ".prog.hex", expect = sc[i].name + ".expect.hex";
+        std::ofstream p((dir + "/" + prog).c_str()), e((dir + "/" + expect).c_str());
+        p << std::hex << std::setfill('0') << "// " << sc[i].name << ": registers at @0, program at @20\n@0\n";
+        for (int r = 0; r < 32; ++r) p << std::setw(8) << img.header->regs[r] << "\n";
+        p << "@20\n";
+        for (uint32_t w = 0; w < img.header->num_words; ++w) p << std::setw(8) << img.words[w] << "\n";
+        e << std::hex << std::setfill('0') << "// " << sc[i].name << ": final registers\n";
+        for (int r = 0; r < 32; ++r) e << std::setw(8) << res[i].regs[r] << "\n";
+        if (!p || !e) { std::cerr << "cannot write " << dir << "/" << sc[i].name << ".*.hex\n"; return false; }
+        list << prog << " " << expect << " " << std::dec << sc[i].cycles << "\n";
+        ++written;
+    }
+    std::cerr << "wrote " << written << " SystemVerilog tests to " << dir << "/tests.txt\n";
+    return (bool)list;
+}
+
+// Entry point for a farm binary's sc_main
+static inline int farm_main(int argc, char* argv[], const farm_model_t& model) {
+    farm_options opt;
+    if (!parse_farm_args(argc, argv, opt)) return 1;
+    if (!opt.gen_dir.empty()) return farm_generate(model, opt.gen_dir, opt.gen_count, opt.gen_cycles, opt.gen_length);
+    if (!opt.sv_tests.empty() && !model.rv32f_images) {
+        std::cerr << "--sv-tests needs RV32F images; " << model.name << " uses its own encoding\n";
+        return 1;
+    }
+
+    std::vector<farm_scenario_t> scenarios;
+    std::string error;
+    if (!farm_parse_manifest(opt.manifest, scenarios, error)) { std::cerr << error << "\n"; return 1; }
+
+    // Map every distinct image once, before any fork
+    std::map<std::string, fpu_image_view> images;
+    for (const farm_scenario_t& s : scenarios) {
+        if (images.count(s.image)) continue;
+        fpu_image_view v;
+        if (!farm_map_image(s.image, v, error)) { std::cerr << error << "\n"; return 1; }
+        if (v.header->num_words > model.max_words) {
+            std::cerr << s.image << ": " << v.header->num_words << " words, the model holds " << model.max_words << "\n";
+            return 1;
+        }
+        images[s.image] = v;
+    }
+
+    size_t bytes = std::max<size_t>(1, scenarios.size()) * sizeof(farm_result_t);
+    farm_result_t* results = static_cast<farm_result_t*>(
+        mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0));
+    if (results == MAP_FAILED) { std::cerr << "cannot map result area\n"; return 1; }
+    std::memset(results, 0, bytes);
+
+    int jobs = opt.jobs > 0 ? opt.jobs : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (jobs < 1) jobs = 1;
+    std::cout.flush();
+    std::cerr.flush();
+
+    struct worker_t { pid_t pid; size_t index; bench_timer started; bool killed; };
+    std::vector<worker_t> running;
+    size_t next = 0;
+    bench_timer wall;
+    while (next < scenarios.size() || !running.empty()) {
+        while (next < scenarios.size() && (int)running.size() < jobs) {
+            pid_t pid = fork();
+            if (pid < 0) { std::cerr << "fork failed\n"; break; }
+            if (pid == 0) {
+                if (!opt.verbose && !std::freopen("/dev/null", "w", stdout)) _exit(2);
+                const farm_scenario_t& s = scenarios[next];
+                farm_result_t& r = results[next];
+                bench_timer t;
+                std::string err;
+                if (!farm_retire_begin(opt.retire_log, opt.reference, s, err)) {
+                    r.status = FARM_FAIL;
+                    std::snprintf(r.message, sizeof(r.message), "%s", err.c_str());
+                    _exit(0);
+                }
+                model.run(s, images[s.image], r);
+                farm_retire_end(r);
+                r.wall_seconds = t.seconds();
+                std::fflush(stdout);
+                _exit(0);   // skip SystemC teardown, the result is already in shared memory
+            }
+            worker_t w = {pid, next++, bench_timer(), false};
+            running.push_back(w);
+        }
+
+        int st;
+        pid_t done = waitpid(-1, &st, opt.timeout > 0 ? WNOHANG : 0);
+        if (done == 0) {
+            for (worker_t& w : running) {
+                if (!w.killed && w.started.seconds() > opt.timeout) {
+                    kill(w.pid, SIGKILL);
+                    w.killed = true;
+                }
+            }
+            usleep(2000);
+            continue;
+        }
+        if (done < 0) break;
+        for (size_t k = 0; k < running.size(); ++k) {
+            if (running[k].pid != done) continue;
+            farm_result_t& r = results[running[k].index];
+            if (WIFSIGNALED(st)) {
+                r.status = running[k].killed ? FARM_TIMEOUT : FARM_CRASH;
+                std::snprintf(r.message, sizeof(r.message), "signal %d", WTERMSIG(st));
+                r.wall_seconds = running[k].started.seconds();
+            } else if (r.status == FARM_PENDING) {
+                r.status = FARM_CRASH;
+                std::snprintf(r.message, sizeof(r.message), "exit status %d", WEXITSTATUS(st));
+            }
+            running.erase(running.begin() + k);
+            break;
+        }
+    }
+    double wall_secs = wall.seconds();
+
+    farm_report(std::cout, model, scenarios, results, jobs, wall_secs, opt.verbose);
+    if (!opt.json.empty()) {
+        std::ofstream out(opt.json.c_str());
+        farm_write_json(out, model, scenarios, results, wall_secs);
+    }
+
+    bool all_pass = true;
+    for (size_t i = 0; i < scenarios.size(); ++i) all_pass = all_pass && results[i].status == FARM_PASS;
+    if (!opt.sv_tests.empty() && !farm_write_sv_tests(opt.sv_tests, scenarios, images, results)) all_pass = false;
+    munmap(results, bytes);
+    return all_pass ? 0 : 1;
+}
+
+#endif // FPU_FARM_H
@@ -0,0 +1,81 @@
+// Scenario farm for the non-pipelined FPPipelinedProcessor (see farm.h).
+// A program shorter than the instruction memory ends at the first zero word,
+// where the IFU stops the simulation itself.
+
+#include <systemc.h>
+#include "processor.h"
+#include "farm.h"
+
+// Counts register-file writes on the falling edge and feeds the writeback
+// stream.
+SC_MODULE(FarmRetireCounter) {
+    sc_in<bool> clk;
+
+    FPPipelinedProcessor* system;
+    uint64_t cycles, retired;
+
+    void monitor() {
+        ++cycles;
+        if (system->wb_valid_out.read() && system->wb_reg_write_en.read()) {
+            ++retired;
+            farm_retire(system->wb_rd_out.read().to_uint(), system->wb_result_out.read().to_uint());
+        }
+    }
+
+    SC_CTOR(FarmRetireCounter) : system(nullptr), cycles(0), retired(0) {
+        SC_METHOD(monitor);
+        sensitive << clk.neg();
+        dont_initialize();
+    }
+};
+
+static const char* const nonpipelined_counter_names[] = {"writebacks_nan_or_inf"};
+
+static void run_nonpipelined(const farm_scenario_t& s, const fpu_image_view& img, farm_result_t& r) {
+    sc_clock clock("clk", 10, SC_NS);
+    sc_signal<bool> reset;
+    sc_signal<bool> stall_signal;
+    sc_signal<bool> monitor_valid;
+    sc_signal<sc_uint<8>> monitor_pc;
+
+    FPPipelinedProcessor system("system");
+    system.clk(clock);
+    system.reset(reset);
+    system.stall(stall_signal);
+    system.monitor_valid(monitor_valid);
+    system.monitor_pc(monitor_pc);
+
+    FarmRetireCounter counter("counter");
+    counter.clk(clock);
+    counter.system = &system;
+
+    system.imem.load(img.words, img.header->num_words);
+    for (int i = 0; i < 32; ++i) system.reg_file[i].write(img.header->regs[i]);
+
+    reset.write(true);
+    stall_signal.write(false);
+    sc_start(15, SC_NS);
+    reset.write(false);
+    sc_start(sc_time(10.0 * s.cycles, SC_NS));
+
+    uint32_t regs[32];
+    for (int i = 0; i < 32; ++i) {
+        regs[i] = system.reg_file[i].read().to_uint();
+        if (((regs[i] >> 23) & 0xFF) == 0xFF) ++r.counters[0];
+    }
+    r.cycles  = counter.cycles;
+    r.retired = counter.retired;
+    farm_check_expects(s, regs, r);
+}
+
+int sc_main(int argc, char* argv[]) {
+    farm_model_t model;
+    model.name          = "nonpipelined";
+    model.num_counters  = 1;
+    model.counter_names = nonpipelined_counter_names;
+    model.run           = run_nonpipelined;
+    model.encode        = encode_rv32f;
+    model.max_words     = InstructionMemory::DEPTH;
+    model.rv32f_images  = true;
+    return farm_main(argc, argv, model);
+}
@@ -0,0 +1,87 @@
+// Scenario farm for FPU_Pipeline_Top (see farm.h).
+//   fpu_farm_pipelined --generate scenarios 1000
+//   fpu_farm_pipelined -j 8 --json farm.json scenarios/manifest.txt
+
+#include "PipelinedFPUUnitsProcessor.h"
+#include "farm.h"
+
+static const char* const pipelined_counter_names[] = {
+    "fetched", "retired_fadd", "retired_fsub", "retired_fmul", "retired_fdiv",
+    "div_dropped", "div_full_cycles", "exc_invalid",
+    "exc_overflow", "exc_underflow", "exc_divide_by_zero", "exc_inexact"
+};
+static const perf_counter_id pipelined_counter_ids[] = {
+    PERF_FETCHED, PERF_RETIRED_FADD, PERF_RETIRED_FSUB, PERF_RETIRED_FMUL, PERF_RETIRED_FDIV,
+    PERF_DIV_DROPPED, PERF_DIV_FULL_CYCLES, PERF_EXC_INVALID,
+    PERF_EXC_OVERFLOW, PERF_EXC_UNDERFLOW, PERF_EXC_DIVIDE_BY_ZERO, PERF_EXC_INEXACT
+};
+static const int PIPELINED_COUNTERS = sizeof(pipelined_counter_ids) / sizeof(pipelined_counter_ids[0]);
+
+// Feeds the writeback stream; the farm never stalls, so every valid
+// Execute output is written back on the next rising edge
+SC_MODULE(FarmWritebackMonitor) {
+    sc_in<bool> clk;
+
+    FPU_Pipeline_Top* fpu;
+
+    void monitor() {
+        const execute_to_wb_t& e = fpu->execute_to_wb.read();
+        if (e.valid) farm_retire(e.rd.to_uint(), e.result.to_uint());
+    }
+
+    SC_CTOR(FarmWritebackMonitor) : fpu(nullptr) {
+        SC_METHOD(monitor);
+        sensitive << clk.neg();
+        dont_initialize();
+    }
+};
+
+static void run_pipelined(const farm_scenario_t& s, const fpu_image_view& img, farm_result_t& r) {
+    sc_clock clk("clk", 10, SC_NS);
+    sc_signal<bool> reset;
+    sc_signal<bool> stall;
+
+    FPU_Pipeline_Top fpu("fpu_pipeline");
+    fpu.clk(clk);
+    fpu.reset(reset);
+    fpu.stall(stall);
+
+    FarmWritebackMonitor wb_monitor("wb_monitor");
+    wb_monitor.clk(clk);
+    wb_monitor.fpu = &fpu;
+
+    reset.write(true);
+    stall.write(false);
+    sc_start(25, SC_NS);
+    reset.write(false);
+
+    std::vector<sc_uint<32>> words(img.words, img.words + img.header->num_words);
+    fpu.fetch_stage->load_program(words.data(), (int)words.size());
+    for (int i = 1; i < 32; ++i) fpu.register_file->set_register_bits(i, img.header->regs[i]);
+
+    sc_start(sc_time(10.0 * s.cycles, SC_NS));
+
+    uint32_t regs[32];
+    for (int i = 0; i < 32; ++i) regs[i] = fpu.register_file->read_register(i).to_uint();
+    r.cycles = fpu.decode_stage->read_perf_counter(PERF_CYCLES).to_uint64();
+    for (int i = PERF_RETIRED_FADD; i <= PERF_RETIRED_OTHER; ++i)
+        r.retired += fpu.decode_stage->read_perf_counter(i).to_uint64();
+    for (int c = 0; c < PIPELINED_COUNTERS; ++c)
+        r.counters[c] = fpu.decode_stage->read_perf_counter(pipelined_counter_ids[c]).to_uint64();
+    farm_check_expects(s, regs, r);
+}
+
+static uint32_t encode_pipelined(const bench_inst_t& i) {
+    return fp_instruction_t(i.op, i.rd, i.rs1, i.rs2).to_word().to_uint();
+}
+
+int sc_main(int argc, char* argv[]) {
+    farm_model_t model;
+    model.name          = "pipelined";
+    model.num_counters  = PIPELINED_COUNTERS;
+    model.counter_names = pipelined_counter_names;
+    model.run           = run_pipelined;
+    model.encode        = encode_pipelined;
+    model.max_words     = 256;
+    return farm_main(argc, argv, model);
+}
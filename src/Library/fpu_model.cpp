@@ -0,0 +1,181 @@
+// libfpumodel: see fpu_model.h.
+
+#include "PipelinedFPUUnitsProcessor.h"
+#include "fpu_model.h"
+
+static_assert((int)FPU_MODEL_FLAG_INVALID == (int)FP_INVALID_OP && (int)FPU_MODEL_FLAG_INEXACT == (int)FP_INEXACT,
+              "fpu_model.h flags must match fp_exceptions");
+
+namespace {
+
+// The one elaborated design. A context's state lives here while it is the
+// active one and in its own checkpoint buffer otherwise. Every call leaves
+// the clock 5 ns after a rising edge, so any snapshot resumes at the phase
+// it was taken at.
+struct fpu_model_design {
+    sc_clock             clk;
+    sc_signal<bool>      reset;
+    sc_signal<bool>      stall;
+    FPU_Pipeline_Top     top;
+    std::vector<uint8_t> reset_state;
+    fpu_model*           active;
+
+    fpu_model_design() : clk("clk", 10, SC_NS), top("fpu_pipeline"), active(nullptr) {
+        top.clk(clk);
+        top.reset(reset);
+        top.stall(stall);
+        reset.write(true);
+        stall.write(false);
+        sc_start(25, SC_NS);
+        reset.write(false);
+        top.save_checkpoint(reset_state);
+    }
+
+    // Checkpoint.h restores signals with write(), so let one delta cycle pass
+    // for them (and what reads them combinationally) to take the values
+    void restore(const std::vector<uint8_t>& state) {
+        top.load_checkpoint(state);
+        sc_start(SC_ZERO_TIME);
+    }
+
+    bool idle() const {
+        return top.fetch_stage->pc >= top.fetch_stage->imem_size && !top.fetch_to_decode.read().valid &&
+               !top.decode_to_execute.read().valid && !top.execute_to_wb.read().valid &&
+               top.execute_div_busy.read() == 0;
+    }
+};
+
+// Never destroyed: the SystemC kernel may already be gone at exit
+fpu_model_design& design() {
+    static fpu_model_design* d = new fpu_model_design();
+    return *d;
+}
+
+} // namespace
+
+struct fpu_model {
+    std::vector<uint8_t> state;   // valid while another context is active
+};
+
+// Makes m the context the design holds
+static fpu_model_design& activate(fpu_model* m) {
+    fpu_model_design& d = design();
+    if (d.active != m) {
+        if (d.active) d.top.save_checkpoint(d.active->state);
+        d.restore(m->state);
+        d.active = m;
+    }
+    return d;
+}
+
+// libsystemc's main() refers to sc_main; hosts of this library define their
+// own main, and one with an sc_main of its own takes precedence
+__attribute__((weak, visibility("default"))) int sc_main(int, char*[]) { return 1; }
+
+extern "C" {
+
+fpu_model* fpu_model_create(void) {
+    fpu_model* m = new fpu_model();
+    m->state = design().reset_state;
+    return m;
+}
+
+void fpu_model_destroy(fpu_model* m) {
+    if (!m) return;
+    fpu_model_design& d = design();
+    if (d.active == m) d.active = nullptr;
+    delete m;
+}
+
+void fpu_model_reset(fpu_model* m) {
+    fpu_model_design& d = activate(m);
+    d.restore(d.reset_state);
+}
+
+uint32_t fpu_model_encode(unsigned opcode, unsigned rd, unsigned rs1, unsigned rs2) {
+    return fp_instruction_t(opcode, rd, rs1, rs2).to_word().to_uint();
+}
+
+int fpu_model_load_program(fpu_model* m, const uint32_t* words, unsigned count) {
+    if (count > FPU_MODEL_IMEM_WORDS) return -1;
+    Fetch* f = activate(m).top.fetch_stage;
+    sc_uint<32> program[FPU_MODEL_IMEM_WORDS];
+    for (unsigned i = 0; i < count; ++i) program[i] = words[i];
+    f->load_program(program, (int)count);
+    f->pc = 0;
+    return 0;
+}
+
+void fpu_model_set_register(fpu_model* m, unsigned reg, uint32_t bits) {
+    activate(m).top.register_file->set_register_bits((int)reg, bits);
+}
+
+uint32_t fpu_model_get_register(fpu_model* m, unsigned reg) {
+    return activate(m).top.register_file->read_register((int)reg).to_uint();
+}
+
+void fpu_model_set_registers(fpu_model* m, const uint32_t regs[32]) {
+    RegisterFile* rf = activate(m).top.register_file;
+    for (int r = 1; r < 32; ++r) rf->set_register_bits(r, regs[r]);
+}
+
+void fpu_model_get_registers(fpu_model* m, uint32_t regs[32]) {
+    RegisterFile* rf = activate(m).top.register_file;
+    for (int r = 0; r < 32; ++r) regs[r] = rf->read_register(r).to_uint();
+}
+
+uint32_t fpu_model_get_flags(fpu_model* m) {
+    return activate(m).top.register_file->get_exception_flags().to_uint();
+}
+
+void fpu_model_clear_flags(fpu_model* m) {
+    activate(m).top.register_file->clear_exception_flags();
+}
+
+uint64_t fpu_model_run(fpu_model* m, uint64_t cycles) {
+    activate(m);
+    if (cycles) sc_start(sc_time(10.0 * cycles, SC_NS));
+    return cycles;
+}
+
+uint64_t fpu_model_run_until_drained(fpu_model* m, uint64_t max_cycles) {
+    fpu_model_design& d = activate(m);
+    // An instruction is out of sight for DEPTH cycles inside Execute's pipe,
+    // so one more idle cycle than that means it is empty as well
+    uint64_t run = 0;
+    unsigned quiet = 0;
+    while (run < max_cycles && quiet <= Execute::DEPTH) {
+        sc_start(10, SC_NS);
+        ++run;
+        quiet = d.idle() ? quiet + 1 : 0;
+    }
+    return run;
+}
+
+void fpu_model_evaluate(fpu_model* m, unsigned opcode, const uint32_t* a, const uint32_t* b, uint32_t* result,
+                        uint8_t* flags, size_t n) {
+    (void)m;
+    Execute* ex = design().top.execute_stage;
+    for (size_t i = 0; i < n; ++i) {
+        sc_uint<8> exc = 0;
+        result[i] = ex->evaluate(opcode, a[i], b[i], exc).to_uint();
+        if (flags) flags[i] = (uint8_t)exc.to_uint();
+    }
+}
+
+unsigned fpu_model_counter_count(void) { return PERF_COUNTER_NUM; }
+
+const char* fpu_model_counter_name(unsigned id) {
+    return id < PERF_COUNTER_NUM ? perf_counter_names[id] : nullptr;
+}
+
+uint64_t fpu_model_read_counter(fpu_model* m, unsigned id) {
+    return activate(m).top.decode_stage->read_perf_counter(id).to_uint64();
+}
+
+void fpu_model_read_counters(fpu_model* m, uint64_t* counters) {
+    Decode* dec = activate(m).top.decode_stage;
+    for (unsigned i = 0; i < PERF_COUNTER_NUM; ++i) counters[i] = dec->read_perf_counter(i).to_uint64();
+}
+
+} // extern "C"
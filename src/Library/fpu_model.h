@@ -0,0 +1,95 @@
+#ifndef FPU_MODEL_H
+#define FPU_MODEL_H
+
+/*
+ * libfpumodel: the pipelined SystemC core (FPU_Pipeline_Top) behind a C API,
+ * for tools and Python (fpumodel.py) that want to call the model in-process
+ * instead of running an sc_main per job.
+ *
+ * The design is elaborated once, on the first fpu_model_create(). Every
+ * context shares it: the one in use owns the hierarchy, and switching to
+ * another swaps the state through Checkpoint.h. Nothing is re-elaborated,
+ * so calls cost microseconds plus the cycles they simulate.
+ *
+ * Programs are fp_instruction_t words (fpu_model_encode()). Registers,
+ * flags and counters are the core's own; flags use the fp_exceptions bits
+ * (FPU_MODEL_FLAG_*), counters the perf_counter_id order.
+ *
+ * Not thread-safe: SystemC has one kernel per process, so use the library
+ * from one thread.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__GNUC__)
+#define FPU_MODEL_API __attribute__((visibility("default")))
+#else
+#define FPU_MODEL_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+    FPU_MODEL_OP_FADD = 0,
+    FPU_MODEL_OP_FSUB = 1,
+    FPU_MODEL_OP_FMUL = 2,
+    FPU_MODEL_OP_FDIV = 3
+};
+
+enum {
+    FPU_MODEL_FLAG_INVALID   = 0x1,
+    FPU_MODEL_FLAG_OVERFLOW  = 0x2,
+    FPU_MODEL_FLAG_UNDERFLOW = 0x4,
+    FPU_MODEL_FLAG_DIV_ZERO  = 0x8,
+    FPU_MODEL_FLAG_INEXACT   = 0x10
+};
+
+#define FPU_MODEL_IMEM_WORDS 256
+
+typedef struct fpu_model fpu_model;
+
+/* A context out of reset: empty program, registers and counters zero */
+FPU_MODEL_API fpu_model* fpu_model_create(void);
+FPU_MODEL_API void       fpu_model_destroy(fpu_model* m);
+FPU_MODEL_API void       fpu_model_reset(fpu_model* m);
+
+FPU_MODEL_API uint32_t fpu_model_encode(unsigned opcode, unsigned rd, unsigned rs1, unsigned rs2);
+
+/* Replaces the program and restarts fetch at word 0. -1 if count is over
+   FPU_MODEL_IMEM_WORDS. */
+FPU_MODEL_API int fpu_model_load_program(fpu_model* m, const uint32_t* words, unsigned count);
+
+/* f0 reads as zero and ignores writes. Writes reach the register file on
+   the next clock, reads see them at once. */
+FPU_MODEL_API void     fpu_model_set_register(fpu_model* m, unsigned reg, uint32_t bits);
+FPU_MODEL_API uint32_t fpu_model_get_register(fpu_model* m, unsigned reg);
+FPU_MODEL_API void     fpu_model_set_registers(fpu_model* m, const uint32_t regs[32]);
+FPU_MODEL_API void     fpu_model_get_registers(fpu_model* m, uint32_t regs[32]);
+FPU_MODEL_API uint32_t fpu_model_get_flags(fpu_model* m);
+FPU_MODEL_API void     fpu_model_clear_flags(fpu_model* m);
+
+/* Both return the cycles simulated. run_until_drained stops once the program
+   is fetched and every result is written back, or after max_cycles. */
+FPU_MODEL_API uint64_t fpu_model_run(fpu_model* m, uint64_t cycles);
+FPU_MODEL_API uint64_t fpu_model_run_until_drained(fpu_model* m, uint64_t max_cycles);
+
+/* result[i], flags[i] = a[i] op b[i] for i < n, through Execute's
+   functional model (Execute::evaluate(): the pipeline's arithmetic without
+   its timing). flags may be NULL. Leaves the context's state alone. */
+FPU_MODEL_API void fpu_model_evaluate(fpu_model* m, unsigned opcode, const uint32_t* a, const uint32_t* b,
+                                      uint32_t* result, uint8_t* flags, size_t n);
+
+FPU_MODEL_API unsigned    fpu_model_counter_count(void);
+FPU_MODEL_API const char* fpu_model_counter_name(unsigned id);
+FPU_MODEL_API uint64_t    fpu_model_read_counter(fpu_model* m, unsigned id);
+/* counters[0 .. fpu_model_counter_count() - 1] */
+FPU_MODEL_API void        fpu_model_read_counters(fpu_model* m, uint64_t* counters);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FPU_MODEL_H */
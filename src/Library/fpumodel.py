@@ -0,0 +1,144 @@
+"""ctypes wrapper for libfpumodel (fpu_model.h).
+
+    from fpumodel import FPUModel, FADD, FMUL
+
+    m = FPUModel()                      # finds libfpumodel.so next to this file
+    m.set_registers({1: 0x40490FD0, 2: 0x402DF84D})
+    m.load_program([FPUModel.encode(FADD, 3, 1, 2), FPUModel.encode(FMUL, 4, 1, 2)])
+    cycles = m.run_until_drained()
+    print(hex(m.get_register(3)), m.counters()["retired_fadd"])
+
+    results, flags = m.evaluate(FMUL, [0x3F800000] * 4, [0x40000000] * 4)
+
+Set FPUMODEL_LIB to load the library from somewhere else.
+"""
+
+import ctypes
+import os
+
+FADD, FSUB, FMUL, FDIV = 0, 1, 2, 3
+
+FLAG_INVALID, FLAG_OVERFLOW, FLAG_UNDERFLOW, FLAG_DIV_ZERO, FLAG_INEXACT = 0x1, 0x2, 0x4, 0x8, 0x10
+
+IMEM_WORDS = 256
+
+_u32 = ctypes.c_uint32
+_u64 = ctypes.c_uint64
+_lib = None
+
+
+def _load():
+    global _lib
+    if _lib is not None:
+        return _lib
+    path = os.environ.get("FPUMODEL_LIB") or os.path.join(os.path.dirname(os.path.abspath(__file__)), "libfpumodel.so")
+    lib = ctypes.CDLL(path)
+    sigs = {
+        "fpu_model_create": (ctypes.c_void_p, []),
+        "fpu_model_destroy": (None, [ctypes.c_void_p]),
+        "fpu_model_reset": (None, [ctypes.c_void_p]),
+        "fpu_model_encode": (_u32, [ctypes.c_uint, ctypes.c_uint, ctypes.c_uint, ctypes.c_uint]),
+        "fpu_model_load_program": (ctypes.c_int, [ctypes.c_void_p, ctypes.POINTER(_u32), ctypes.c_uint]),
+        "fpu_model_set_register": (None, [ctypes.c_void_p, ctypes.c_uint, _u32]),
+        "fpu_model_get_register": (_u32, [ctypes.c_void_p, ctypes.c_uint]),
+        "fpu_model_set_registers": (None, [ctypes.c_void_p, ctypes.POINTER(_u32)]),
+        "fpu_model_get_registers": (None, [ctypes.c_void_p, ctypes.POINTER(_u32)]),
+        "fpu_model_get_flags": (_u32, [ctypes.c_void_p]),
+        "fpu_model_clear_flags": (None, [ctypes.c_void_p]),
+        "fpu_model_run": (_u64, [ctypes.c_void_p, _u64]),
+        "fpu_model_run_until_drained": (_u64, [ctypes.c_void_p, _u64]),
+        "fpu_model_evaluate": (None, [ctypes.c_void_p, ctypes.c_uint, ctypes.POINTER(_u32), ctypes.POINTER(_u32),
+                                      ctypes.POINTER(_u32), ctypes.POINTER(ctypes.c_uint8), ctypes.c_size_t]),
+        "fpu_model_counter_count": (ctypes.c_uint, []),
+        "fpu_model_counter_name": (ctypes.c_char_p, [ctypes.c_uint]),
+        "fpu_model_read_counter": (_u64, [ctypes.c_void_p, ctypes.c_uint]),
+        "fpu_model_read_counters": (None, [ctypes.c_void_p, ctypes.POINTER(_u64)]),
+    }
+    for name, (res, args) in sigs.items():
+        fn = getattr(lib, name)
+        fn.restype = res
+        fn.argtypes = args
+    _lib = lib
+    return lib
+
+
+class FPUModel:
+    """One context of the pipelined core. Contexts share one elaborated design."""
+
+    def __init__(self):
+        self._lib = _load()
+        self._m = self._lib.fpu_model_create()
+        n = self._lib.fpu_model_counter_count()
+        self.counter_names = [self._lib.fpu_model_counter_name(i).decode() for i in range(n)]
+
+    def close(self):
+        if self._m:
+            self._lib.fpu_model_destroy(self._m)
+            self._m = None
+
+    def __del__(self):
+        self.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    @staticmethod
+    def encode(opcode, rd, rs1, rs2):
+        return _load().fpu_model_encode(opcode, rd, rs1, rs2)
+
+    def reset(self):
+        self._lib.fpu_model_reset(self._m)
+
+    def load_program(self, words):
+        words = list(words)
+        if self._lib.fpu_model_load_program(self._m, (_u32 * len(words))(*words), len(words)) != 0:
+            raise ValueError("program longer than %d words" % IMEM_WORDS)
+
+    def set_register(self, reg, bits):
+        self._lib.fpu_model_set_register(self._m, reg, bits)
+
+    def get_register(self, reg):
+        return self._lib.fpu_model_get_register(self._m, reg)
+
+    def set_registers(self, regs):
+        """regs: 32 values (f0 ignored) or a {register: bits} dict"""
+        if isinstance(regs, dict):
+            for r, v in regs.items():
+                self.set_register(r, v)
+        else:
+            self._lib.fpu_model_set_registers(self._m, (_u32 * 32)(*regs))
+
+    def get_registers(self):
+        out = (_u32 * 32)()
+        self._lib.fpu_model_get_registers(self._m, out)
+        return list(out)
+
+    def flags(self):
+        return self._lib.fpu_model_get_flags(self._m)
+
+    def clear_flags(self):
+        self._lib.fpu_model_clear_flags(self._m)
+
+    def run(self, cycles):
+        return self._lib.fpu_model_run(self._m, cycles)
+
+    def run_until_drained(self, max_cycles=1 << 20):
+        return self._lib.fpu_model_run_until_drained(self._m, max_cycles)
+
+    def evaluate(self, opcode, a, b):
+        """Element-wise a op b through the functional model: (results, flags)"""
+        a, b = list(a), list(b)
+        if len(a) != len(b):
+            raise ValueError("operand arrays differ in length")
+        n = len(a)
+        res, fl = (_u32 * n)(), (ctypes.c_uint8 * n)()
+        self._lib.fpu_model_evaluate(self._m, opcode, (_u32 * n)(*a), (_u32 * n)(*b), res, fl, n)
+        return list(res), list(fl)
+
+    def counters(self):
+        out = (_u64 * len(self.counter_names))()
+        self._lib.fpu_model_read_counters(self._m, out)
+        return dict(zip(self.counter_names, out))
@@ -1,259 +1,6 @@
 #include <systemc.h>
-#include "IEEE754Add.h"
-#include "IEEE754Div.h"
-#include "IEEE754Mult.h"
-#include "IEEE754Sub.h"
-#include "mem_wb.h"
-#include "execute.h"
-#include "imem.h"
-
-SC_MODULE(FPPipelinedProcessor) {
-    sc_in<bool> clk;
-    sc_in<bool> reset;
-    sc_in<bool> stall;
-    sc_out<bool> monitor_valid;
-    sc_out<sc_uint<8>> monitor_pc;
-
-    sc_signal<bool> internal_stall;
-    
-    sc_signal<sc_uint<32>> pc_out;
-    sc_signal<sc_uint<32>> ifu_instruction_out;
-    sc_signal<bool> ifu_valid_out;
-
-    sc_signal<sc_uint<32>> op1_out, op2_out;
-    sc_signal<sc_uint<5>> rd_out;
-    sc_signal<bool> reg_write_out;
-    sc_signal<bool> decode_valid_out;
-    sc_signal<sc_uint<32>> decode_instruction_out;
-
-    sc_signal<sc_uint<7>> opcode;
-    sc_signal<sc_uint<32>> ex_result_out;
-    sc_signal<sc_uint<5>> ex_rd_out;
-    sc_signal<bool> ex_reg_write_out;
-    sc_signal<bool> ex_valid_out;
-    sc_signal<sc_uint<32>> ex_instruction_out;
-
-    // Fixed: Changed from ac_uint to sc_uint
-    sc_signal<sc_uint<32>> mem_result_out;
-    sc_signal<sc_uint<5>> mem_rd_out;
-    sc_signal<bool> mem_reg_write_out;
-    sc_signal<bool> mem_valid_out;
-    sc_signal<sc_uint<32>> mem_instruction_out;
-
-    sc_signal<sc_uint<32>> wb_result_out;
-    sc_signal<sc_uint<5>> wb_rd_out;
-    sc_signal<bool> wb_reg_write_en;
-    sc_signal<bool> wb_valid_out;
-
-    sc_signal<sc_uint<32>> reg_file[32];
-    
-    sc_signal<sc_uint<32>> imem_address;
-    sc_signal<sc_uint<32>> imem_instruction;
-
-    InstructionMemory imem;
-    Execute execute;
-    Memory memory;
-    Writeback writeback;
-
-    void update_opcode() {
-        opcode.write(decode_instruction_out.read().range(31, 25));
-    }
-
-    void update_stall() {
-        internal_stall.write(stall.read());
-    }
-
-    void ifu_process() {
-        sc_uint<32> pc = 0;
-        bool terminated = false;
-        
-        ifu_instruction_out.write(0);
-        ifu_valid_out.write(false);
-        pc_out.write(0);
-        imem_address.write(0);
-        
-        while (true) {
-            if (reset.read()) {
-                pc = 0;
-                terminated = false;
-                ifu_instruction_out.write(0);
-                ifu_valid_out.write(false);
-                pc_out.write(0);
-                imem_address.write(0);
-            } else if (!internal_stall.read() && !terminated) {
-                sc_uint<32> current_pc = pc;
-                
-                imem_address.write(current_pc);
-                
-                sc_uint<32> instruction = imem_instruction.read();
-                
-                ifu_instruction_out.write(instruction);
-                ifu_valid_out.write(instruction != 0);
-                pc_out.write(current_pc);
-                
-                if (instruction == 0) {
-                    terminated = true;
-                    ifu_valid_out.write(false);
-                } else {
-                    pc = current_pc + 4;
-                }
-                
-                cout << "IFU @" << sc_time_stamp() << ": PC=" << hex << current_pc 
-                     << " Instruction=0x" << instruction << endl;
-                
-                if (terminated && pc_out.read() >= 16) {
-                    cout << "\nFinal Register File Contents:" << endl;
-                    for (int i = 1; i <= 19; i++) {
-                        if (i <= 11 || (i >= 16 && i <= 19)) {
-                            cout << "f" << i << ": 0x" << hex << reg_file[i].read() << endl;
-                        }
-                    }
-                    
-                    cout << "\n=== Simulation Complete ===\n" << endl;
-                    sc_stop();
-                }
-            }
-            
-            wait();
-        }
-    }
-
-    void decode_process() {
-        op1_out.write(0);
-        op2_out.write(0);
-        rd_out.write(0);
-        reg_write_out.write(false);
-        decode_valid_out.write(false);
-        decode_instruction_out.write(0);
-        
-        while (true) {
-            if (reset.read()) {
-                op1_out.write(0);
-                op2_out.write(0);
-                rd_out.write(0);
-                reg_write_out.write(false);
-                decode_valid_out.write(false);
-                decode_instruction_out.write(0);
-            } else if (!internal_stall.read()) {
-                decode_valid_out.write(ifu_valid_out.read());
-                decode_instruction_out.write(ifu_instruction_out.read());
-                
-                if (ifu_valid_out.read() && ifu_instruction_out.read() != 0) {
-                    sc_uint<5> rs1 = (ifu_instruction_out.read() >> 15) & 0x1F;
-                    sc_uint<5> rs2 = (ifu_instruction_out.read() >> 20) & 0x1F;
-                    sc_uint<5> rd = (ifu_instruction_out.read() >> 7) & 0x1F;
-                    
-                    op1_out.write(reg_file[rs1.to_uint()].read());
-                    op2_out.write(reg_file[rs2.to_uint()].read());
-                    rd_out.write(rd);
-                    reg_write_out.write(true);
-                    
-                    cout << "DEC @" << sc_time_stamp() << ": ";
-                    cout << "rs1=f" << rs1 << " (0x" << hex << reg_file[rs1.to_uint()].read() << ") ";
-                    cout << "rs2=f" << rs2 << " (0x" << hex << reg_file[rs2.to_uint()].read() << ") ";
-                    cout << "rd=f" << rd << endl;
-                } else {
-                    op1_out.write(0);
-                    op2_out.write(0);
-                    rd_out.write(0);
-                    reg_write_out.write(false);
-                }
-            }
-            
-            wait();
-        }
-    }
-
-    void reg_file_update() {
-        while (true) {
-            if (reset.read()) {
-            } else if (wb_reg_write_en.read() && wb_valid_out.read()) {
-                unsigned rd_index = wb_rd_out.read().to_uint();
-                if (rd_index < 32) {
-                    reg_file[rd_index].write(wb_result_out.read());
-                    cout << "REG @" << sc_time_stamp() << ": ";
-                    cout << "f" << rd_index << " updated to 0x" << hex << wb_result_out.read() << endl;
-                }
-            }
-            wait();
-        }
-    }
-    
-    void update_monitor() {
-        monitor_valid.write(wb_valid_out.read());
-        monitor_pc.write(pc_out.read().range(7, 0));
-    }
-
-    SC_CTOR(FPPipelinedProcessor) : 
-        imem("instruction_memory"),
-        execute("execute"),
-        memory("memory"),
-        writeback("writeback")
-    {
-        SC_METHOD(update_stall);
-        sensitive << stall;
-        
-        imem.address(imem_address);
-        imem.instruction(imem_instruction);
-        
-        execute.clk(clk);
-        execute.reset(reset);
-        execute.stall(internal_stall);
-        execute.valid_in(decode_valid_out);
-        execute.op1(op1_out);
-        execute.op2(op2_out);
-        execute.opcode(opcode);
-        execute.rd_in(rd_out);
-        execute.reg_write_in(reg_write_out);
-        execute.instruction_in(decode_instruction_out);
-        execute.result_out(ex_result_out);
-        execute.rd_out(ex_rd_out);
-        execute.reg_write_out(ex_reg_write_out);
-        execute.valid_out(ex_valid_out);
-        execute.instruction_out(ex_instruction_out);
-
-        memory.reset(reset);
-        memory.stall(internal_stall);
-        memory.valid_in(ex_valid_out);
-        memory.result_in(ex_result_out);
-        memory.rd_in(ex_rd_out);
-        memory.reg_write_in(ex_reg_write_out);
-        memory.instruction_in(ex_instruction_out);
-        memory.result_out(mem_result_out);
-        memory.rd_out(mem_rd_out);
-        memory.reg_write_out(mem_reg_write_out);
-        memory.valid_out(mem_valid_out);
-        memory.instruction_out(mem_instruction_out);
-
-        writeback.reset(reset);
-        writeback.stall(internal_stall);
-        writeback.valid_in(mem_valid_out);
-        writeback.result_in(mem_result_out);
-        writeback.rd_in(mem_rd_out);
-        writeback.reg_write_in(mem_reg_write_out);
-        writeback.instruction_in(mem_instruction_out);
-        writeback.result_out(wb_result_out);
-        writeback.rd_out(wb_rd_out);
-        writeback.reg_write_en(wb_reg_write_en);
-        writeback.valid_out(wb_valid_out);
-
-        SC_METHOD(update_opcode);
-        sensitive << decode_instruction_out;
-        
-        SC_METHOD(update_monitor);
-        sensitive << wb_valid_out << pc_out;
-        
-        SC_CTHREAD(ifu_process, clk.pos());
-        reset_signal_is(reset, true);
-        
-        SC_CTHREAD(decode_process, clk.pos());
-        reset_signal_is(reset, true);
-        
-        SC_CTHREAD(reg_file_update, clk.pos());
-        reset_signal_is(reset, true);
-    }
-};
-
+#include "processor.h"
+#include "window_trace.h"
 
 uint32_t floatToHex(float value) {
     uint32_t result;
@@ -282,15 +29,79 @@ int sc_main(int argc, char* argv[]) {
     system.monitor_valid(monitor_valid);
     system.monitor_pc(monitor_pc);
     
-    sc_trace_file *wf = sc_create_vcd_trace_file("fp_system");
-    sc_trace(wf, clock, "clk");
-    sc_trace(wf, reset, "reset");
-    sc_trace(wf, stall_signal, "stall");
-    sc_trace(wf, system.pc_out, "pc_out");
-    sc_trace(wf, system.ifu_instruction_out, "instruction");
-    sc_trace(wf, system.ifu_valid_out, "valid");
-    sc_trace(wf, monitor_valid, "monitor_valid");
-    sc_trace(wf, monitor_pc, "monitor_pc");
+    // Default: keep the last 256 cycles and dump a window around a trigger.
+    // --full-vcd       trace the whole run to fp_system.vcd instead
+    // --trigger-pc N   additionally trigger when the IFU reaches PC N
+    // --commit-log F   Spike --log-commits style log of the test program
+    // --log F          per-stage log to F instead of stdout
+    // --log-level N    0 none, 1 error, 2 info (final registers), 3 debug,
+    //                  4 trace (every stage, the default)
+    // --log-only L     only the categories in L, e.g. ifu,wb
+    bool full_vcd = false;
+    long trigger_pc = -1;
+    const char* commit_file = nullptr;
+    const char* log_file = nullptr;
+    unsigned log_level = SIMLOG_TRACE;
+    uint32_t log_categories = SIMLOG_ALL;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--full-vcd") == 0) full_vcd = true;
+        else if (strcmp(argv[i], "--trigger-pc") == 0 && i + 1 < argc) trigger_pc = strtol(argv[++i], nullptr, 0);
+        else if (strcmp(argv[i], "--commit-log") == 0 && i + 1 < argc) commit_file = argv[++i];
+        else if (strcmp(argv[i], "--log") == 0 && i + 1 < argc) log_file = argv[++i];
+        else if (strcmp(argv[i], "--log-level") == 0 && i + 1 < argc) log_level = (unsigned)strtoul(argv[++i], nullptr, 0);
+        else if (strcmp(argv[i], "--log-only") == 0 && i + 1 < argc) {
+            log_categories = sim_log_parse_categories(argv[++i]);
+            if (!log_categories) {
+                cerr << "unknown log category in " << argv[i] << endl;
+                return 1;
+            }
+        }
+    }
+    if (log_level != SIMLOG_OFF) {
+        bool started = log_file ? SimLog::start(log_file, log_level, log_categories)
+                                : SimLog::start(stdout, log_level, log_categories);
+        if (!started) {
+            cerr << "cannot open log " << log_file << endl;
+            return 1;
+        }
+    }
+
+    sc_trace_file *wf = nullptr;
+    WindowTrace window("window_trace", "fp_system_window", 256, 16);
+    window.clk(clock);
+    if (full_vcd) {
+        wf = sc_create_vcd_trace_file("fp_system");
+        sc_trace(wf, clock, "clk");
+        sc_trace(wf, reset, "reset");
+        sc_trace(wf, stall_signal, "stall");
+        sc_trace(wf, system.pc_out, "pc_out");
+        sc_trace(wf, system.ifu_instruction_out, "instruction");
+        sc_trace(wf, system.ifu_valid_out, "valid");
+        sc_trace(wf, monitor_valid, "monitor_valid");
+        sc_trace(wf, monitor_pc, "monitor_pc");
+    } else {
+        window.add(reset, "reset");
+        window.add(stall_signal, "stall");
+        window.add(system.pc_out, "pc_out");
+        window.add(system.ifu_instruction_out, "instruction");
+        window.add(system.ifu_valid_out, "valid");
+        window.add(system.op1_out, "op1");
+        window.add(system.op2_out, "op2");
+        window.add(system.ex_result_out, "ex_result");
+        window.add(system.wb_result_out, "wb_result");
+        window.add(system.wb_rd_out, "wb_rd");
+        window.add(system.wb_valid_out, "wb_valid");
+        window.add(monitor_valid, "monitor_valid");
+        window.add(monitor_pc, "monitor_pc");
+
+        // No flag register in this model: treat a NaN or infinite result
+        // written back as the exception condition
+        window.add_trigger("wb_nan_or_inf", [&system]() {
+            return system.wb_valid_out.read() && system.wb_reg_write_en.read() &&
+                   ((system.wb_result_out.read() >> 23) & 0xFF) == 0xFF;
+        });
+        if (trigger_pc >= 0) window.trigger_on_value(system.pc_out, sc_uint<32>(trigger_pc), "pc");
+    }
     
     auto createFPInstruction = [](uint8_t funct7, uint8_t rs2, uint8_t rs1, uint8_t rd) -> uint32_t {
         uint32_t instruction = 0;
@@ -303,16 +114,23 @@ int sc_main(int argc, char* argv[]) {
         return instruction;
     };
     
+    // The log is written by another thread: wait for it after each step so
+    // that its lines come before the step's own output
+    auto run = [](int ns) {
+        sc_start(ns, SC_NS);
+        SimLog::flush();
+    };
+
     cout << "\n================ Floating-Point Processor Test ================\n" << endl;
     cout << "Initializing test sequence..." << endl;
     
     stall_signal.write(true);
     reset.write(true);
-    sc_start(15, SC_NS);
+    run(15);
     
     reset.write(false);
     stall_signal.write(true);
-    sc_start(5, SC_NS);
+    run(5);
     
     cout << "Setting initial register values..." << endl;
     
@@ -347,7 +165,7 @@ int sc_main(int argc, char* argv[]) {
         system.wb_rd_out.write(reg.reg_num);
         system.wb_reg_write_en.write(true);
         system.wb_valid_out.write(true);
-        sc_start(10, SC_NS);
+        run(10);
         cout << "  Initialized r" << (int)reg.reg_num << " with " << reg.description 
              << " (" << reg.value << ", 0x" << std::hex << floatToHex(reg.value) 
              << std::dec << ")" << endl;
@@ -358,14 +176,14 @@ int sc_main(int argc, char* argv[]) {
         system.wb_rd_out.write(reg.reg_num);
         system.wb_reg_write_en.write(true);
         system.wb_valid_out.write(true);
-        sc_start(10, SC_NS);
+        run(10);
         cout << "  Initialized r" << (int)reg.reg_num << " with " << reg.description 
              << " (0x" << std::hex << reg.value << std::dec << ")" << endl;
     }
     
     system.wb_valid_out.write(false);
     system.wb_reg_write_en.write(false);
-    sc_start(10, SC_NS);
+    run(10);
     
     cout << "\nLoading test program into instruction memory..." << endl;
     
@@ -399,22 +217,28 @@ int sc_main(int argc, char* argv[]) {
         uint32_t addr = i * 4;
         uint32_t instr = createFPInstruction(test.funct7, test.rs2, test.rs1, test.rd);
         
-        system.imem_address.write(addr);
-        system.imem_instruction.write(instr);
-        sc_start(5, SC_NS);
+        system.imem.write_word(i, instr);
+        run(5);
         
         cout << "  0x" << std::hex << std::setw(8) << std::setfill('0') << instr 
              << std::dec << " @ 0x" << std::hex << addr << std::dec 
              << ": " << test.description << endl;
     }
     
-    system.imem_address.write(sizeof(test_program) / sizeof(TestCase) * 4);
-    system.imem_instruction.write(0);
-    sc_start(5, SC_NS);
+    system.imem.write_word(sizeof(test_program) / sizeof(TestCase), 0);
+    run(5);
     
+    // Started only now, so the register initialisation above is not logged
+    if (commit_file && !CommitLog::start(commit_file)) {
+        cerr << "cannot open commit log " << commit_file << endl;
+        return 1;
+    }
+
     cout << "\nStarting simulation..." << endl;
     stall_signal.write(false);
-    sc_start(1000, SC_NS);
+    run(1000);
+    CommitLog::stop();
+    SimLog::stop();
     
     cout << "\n================ Expected Results ================\n";
     
@@ -440,10 +264,13 @@ int sc_main(int argc, char* argv[]) {
     cout << "r19 (0.0 - 0.0):  Expected 0.0 (0x00000000)" << endl;
     cout << "r20 (1.0 + inf):  Expected Infinity (0x7f800000)" << endl;
     
-    sc_close_vcd_trace_file(wf);
-    
     cout << "\n================ Simulation Complete ================\n";
-    cout << "VCD trace file 'fp_system.vcd' generated for waveform analysis." << endl;
+    if (wf) {
+        sc_close_vcd_trace_file(wf);
+        cout << "VCD trace file 'fp_system.vcd' generated for waveform analysis." << endl;
+    } else {
+        cout << window.dumps() << " triggered VCD window(s) written as fp_system_window_<n>.vcd" << endl;
+    }
     
     return 0;
 }
\ No newline at end of file
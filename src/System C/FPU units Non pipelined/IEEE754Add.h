@@ -12,9 +12,10 @@ SC_MODULE(ieee754_extractor)
     sc_out<sc_uint<24> > mantissa;
 
     void process() {
+        sc_uint<8> exp = A.read().range(30, 23);
         sign.write(A.read()[31]);
-        exponent.write(A.read().range(30, 23));
-        if (exponent.read() == 0) {
+        exponent.write(exp);
+        if (exp == 0) {
             mantissa.write((sc_uint<24>)((sc_uint<1>(0), A.read().range(22, 0))));
         } else {
             mantissa.write((sc_uint<24>)((sc_uint<1>(1), A.read().range(22, 0))));
@@ -23,7 +24,7 @@ SC_MODULE(ieee754_extractor)
 
     SC_CTOR(ieee754_extractor) {
         SC_METHOD(process);
-        sensitive << A<<sign<<exponent<<mantissa;
+        sensitive << A;
     }
 };
 
@@ -43,112 +44,121 @@ SC_MODULE(ieee754_adder_core)
     void process() {
         sc_uint<8> diff = 0;
         sc_uint<24> tmp_mantissa = 0;
+        bool res_sign = false;
+        sc_uint<8> res_exponent = 0;
+        sc_uint<25> res_mantissa = 0;
         bool a_is_nan = (exp_a.read() == 0xFF) && (mant_a.read().range(22, 0) != 0);
         bool b_is_nan = (exp_b.read() == 0xFF) && (mant_b.read().range(22, 0) != 0);
         bool a_is_inf = (exp_a.read() == 0xFF) && (mant_a.read().range(22, 0) == 0);
         bool b_is_inf = (exp_b.read() == 0xFF) && (mant_b.read().range(22, 0) == 0);
 
         if (a_is_nan || b_is_nan) {
-            out_exponent.write(0xFF);
-            out_mantissa.write(0x400000);
-            out_sign.write(false);
+            res_exponent = 0xFF;
+            res_mantissa = 0x400000;
+            res_sign = false;
         } else {
             if (a_is_inf || b_is_inf) {
                 if (a_is_inf && b_is_inf) {
                     if (sign_a.read() == sign_b.read()) {
-                        out_exponent.write(0xFF);
-                        out_mantissa.write(0);
-                        out_sign.write(sign_a.read());
+                        res_exponent = 0xFF;
+                        res_mantissa = 0;
+                        res_sign = sign_a.read();
                     } else {
-                        out_exponent.write(0xFF);
-                        out_mantissa.write(0x400000);
-                        out_sign.write(false);
+                        res_exponent = 0xFF;
+                        res_mantissa = 0x400000;
+                        res_sign = false;
                     }
                 } else {
-                    out_exponent.write(0xFF);
-                    out_mantissa.write(0);
-                    out_sign.write(a_is_inf ? sign_a.read() : sign_b.read());
+                    res_exponent = 0xFF;
+                    res_mantissa = 0;
+                    res_sign = a_is_inf ? sign_a.read() : sign_b.read();
                 }
             } else {
                 if (exp_a.read() == 0 && mant_a.read() == 0) {
-                    out_sign.write(sign_b.read());
-                    out_exponent.write(exp_b.read());
-                    out_mantissa.write((sc_uint<25>)((sc_uint<1>(0), mant_b.read())));
+                    res_sign = sign_b.read();
+                    res_exponent = exp_b.read();
+                    res_mantissa = (sc_uint<25>)((sc_uint<1>(0), mant_b.read()));
                 } else if (exp_b.read() == 0 && mant_b.read() == 0) {
-                    out_sign.write(sign_a.read());
-                    out_exponent.write(exp_a.read());
-                    out_mantissa.write((sc_uint<25>)((sc_uint<1>(0), mant_a.read())));
+                    res_sign = sign_a.read();
+                    res_exponent = exp_a.read();
+                    res_mantissa = (sc_uint<25>)((sc_uint<1>(0), mant_a.read()));
                 } else {
                     if (exp_a.read() == 0) {
-                        out_exponent.write(exp_b.read());
+                        res_exponent = exp_b.read();
                         tmp_mantissa = mant_a.read();
                     } else if (exp_b.read() == 0) {
-                        out_exponent.write(exp_a.read());
+                        res_exponent = exp_a.read();
                         tmp_mantissa = mant_b.read();
                     } else {
-                        out_exponent.write((exp_a.read() > exp_b.read()) ? exp_a.read() : exp_b.read());
+                        res_exponent = (exp_a.read() > exp_b.read()) ? exp_a.read() : exp_b.read();
                     }
 
                     if (exp_a.read() > exp_b.read()) {
                         diff = exp_a.read() - exp_b.read();
-                        tmp_mantissa = mant_b.read() >> diff;
+                        // Operands more than 24 binades apart do not overlap, as
+                        // in FPU.sv; the host shift would wrap at 64
+                        tmp_mantissa = (diff > 24) ? sc_uint<24>(0) : sc_uint<24>(mant_b.read() >> diff);
                         if (sign_a.read() == sign_b.read()) {
-                            out_mantissa.write((sc_uint<25>)((sc_uint<1>(0), mant_a.read())) + 
-                                            (sc_uint<25>)((sc_uint<1>(0), tmp_mantissa)));
+                            res_mantissa = (sc_uint<25>)((sc_uint<1>(0), mant_a.read())) + 
+                                            (sc_uint<25>)((sc_uint<1>(0), tmp_mantissa));
                         } else {
                             if (mant_a.read() >= tmp_mantissa) {
-                                out_mantissa.write((sc_uint<25>)((sc_uint<1>(0), mant_a.read())) - 
-                                              (sc_uint<25>)((sc_uint<1>(0), tmp_mantissa)));
+                                res_mantissa = (sc_uint<25>)((sc_uint<1>(0), mant_a.read())) - 
+                                              (sc_uint<25>)((sc_uint<1>(0), tmp_mantissa));
                             } else {
-                                out_mantissa.write((sc_uint<25>)((sc_uint<1>(0), tmp_mantissa)) - 
-                                              (sc_uint<25>)((sc_uint<1>(0), mant_a.read())));
+                                res_mantissa = (sc_uint<25>)((sc_uint<1>(0), tmp_mantissa)) - 
+                                              (sc_uint<25>)((sc_uint<1>(0), mant_a.read()));
                             }
                         }
-                        out_sign.write((mant_a.read() >= tmp_mantissa) ? sign_a.read() : sign_b.read());
+                        res_sign = (mant_a.read() >= tmp_mantissa) ? sign_a.read() : sign_b.read();
                     } else if (exp_b.read() > exp_a.read()) {
                         diff = exp_b.read() - exp_a.read();
-                        tmp_mantissa = mant_a.read() >> diff;
+                        tmp_mantissa = (diff > 24) ? sc_uint<24>(0) : sc_uint<24>(mant_a.read() >> diff);
                         if (sign_a.read() == sign_b.read()) {
-                            out_mantissa.write((sc_uint<25>)((sc_uint<1>(0), mant_b.read())) + 
-                                            (sc_uint<25>)((sc_uint<1>(0), tmp_mantissa)));
+                            res_mantissa = (sc_uint<25>)((sc_uint<1>(0), mant_b.read())) + 
+                                            (sc_uint<25>)((sc_uint<1>(0), tmp_mantissa));
                         } else {
                             if (mant_b.read() >= tmp_mantissa) {
-                                out_mantissa.write((sc_uint<25>)((sc_uint<1>(0), mant_b.read())) - 
-                                              (sc_uint<25>)((sc_uint<1>(0), tmp_mantissa)));
+                                res_mantissa = (sc_uint<25>)((sc_uint<1>(0), mant_b.read())) - 
+                                              (sc_uint<25>)((sc_uint<1>(0), tmp_mantissa));
                             } else {
-                                out_mantissa.write((sc_uint<25>)((sc_uint<1>(0), tmp_mantissa)) - 
-                                              (sc_uint<25>)((sc_uint<1>(0), mant_b.read())));
+                                res_mantissa = (sc_uint<25>)((sc_uint<1>(0), tmp_mantissa)) - 
+                                              (sc_uint<25>)((sc_uint<1>(0), mant_b.read()));
                             }
                         }
-                        out_sign.write((mant_b.read() >= tmp_mantissa) ? sign_b.read() : sign_a.read());
+                        res_sign = (mant_b.read() >= tmp_mantissa) ? sign_b.read() : sign_a.read();
                     } else {
                         if (sign_a.read() == sign_b.read()) {
-                            out_mantissa.write((sc_uint<25>)((sc_uint<1>(0), mant_a.read())) + 
-                                            (sc_uint<25>)((sc_uint<1>(0), mant_b.read())));
+                            res_mantissa = (sc_uint<25>)((sc_uint<1>(0), mant_a.read())) + 
+                                            (sc_uint<25>)((sc_uint<1>(0), mant_b.read()));
                         } else {
                             if (mant_a.read() > mant_b.read()) {
-                                out_mantissa.write((sc_uint<25>)((sc_uint<1>(0), mant_a.read())) - 
-                                              (sc_uint<25>)((sc_uint<1>(0), mant_b.read())));
+                                res_mantissa = (sc_uint<25>)((sc_uint<1>(0), mant_a.read())) - 
+                                              (sc_uint<25>)((sc_uint<1>(0), mant_b.read()));
                             } else {
-                                out_mantissa.write((sc_uint<25>)((sc_uint<1>(0), mant_b.read())) - 
-                                              (sc_uint<25>)((sc_uint<1>(0), mant_a.read())));
+                                res_mantissa = (sc_uint<25>)((sc_uint<1>(0), mant_b.read())) - 
+                                              (sc_uint<25>)((sc_uint<1>(0), mant_a.read()));
                             }
                         }
-                        out_sign.write((mant_a.read() > mant_b.read()) ? sign_a.read() : sign_b.read());
+                        res_sign = (mant_a.read() > mant_b.read()) ? sign_a.read() : sign_b.read();
                     }
 
-                    if (out_mantissa.read() == 0) {
-                        out_sign.write(false);
-                        out_exponent.write(0);
+                    if (res_mantissa == 0) {
+                        res_sign = false;
+                        res_exponent = 0;
                     }
                 }
             }
         }
+
+        out_sign.write(res_sign);
+        out_exponent.write(res_exponent);
+        out_mantissa.write(res_mantissa);
     }
 
     SC_CTOR(ieee754_adder_core) {
         SC_METHOD(process);
-        sensitive << exp_a << exp_b << mant_a << mant_b << sign_a << sign_b<<out_mantissa;
+        sensitive << exp_a << exp_b << mant_a << mant_b << sign_a << sign_b;
     }
 };
 
@@ -194,7 +204,12 @@ SC_MODULE(ieee754_normalizer)
                 }
 
                 if (norm_exponent >= 0xFF) {
+#ifdef FPU_SHARED_ADDSUB
+                    // Overflow rounds to infinity
+                    result.write((sc_uint<32>)((sign.read(), sc_uint<8>(0xFF), sc_uint<23>(0))));
+#else
                     result.write(0);
+#endif
                 } else {
                     result.write((sc_uint<32>)((sign.read(), norm_exponent, norm_mantissa.range(22, 0))));
                 }
@@ -260,7 +275,41 @@ SC_MODULE(ieee754_adder)
         normalizer->sign(out_sign);
         normalizer->result(O);
     }
-
 };
 
+#ifdef FPU_SHARED_ADDSUB
+//==============================================================================
+//
+// Module: ieee754_addsub
+//
+// Shared datapath for fadd.s and fsub.s: with sub set, B's sign is flipped
+// ahead of the adder, so both opcodes get the same NaN, infinity, zero and
+// denormal handling. Only built with -DFPU_SHARED_ADDSUB until FPU.sv is
+// regenerated from it.
+//
+SC_MODULE(ieee754_addsub)
+{
+    sc_in<sc_uint<32> > A, B;
+    sc_in<bool> sub;
+    sc_out<sc_uint<32> > O;
+
+    sc_signal<sc_uint<32> > b_eff;
+    ieee754_adder *adder;
+
+    void flip_process() {
+        sc_uint<32> b = B.read();
+        b[31] = B.read()[31] ^ sub.read();
+        b_eff.write(b);
+    }
 
+    SC_CTOR(ieee754_addsub) {
+        SC_METHOD(flip_process);
+        sensitive << B << sub;
+
+        adder = new ieee754_adder("adder");
+        adder->A(A);
+        adder->B(b_eff);
+        adder->O(O);
+    }
+};
+#endif
@@ -37,6 +37,50 @@ SC_MODULE(ExtractModule) {
     }
 };
 
+// Restoring-division iterations for a 24-bit significand plus round bit
+static const unsigned IEEE754_DIV_ITERATIONS = 25;
+
+// One restoring-division iteration: next quotient bit into r
+static inline void ieee754_div_step(sc_uint<32>& x_val, sc_uint<32>& r, sc_uint<32> y_val) {
+    r = r << 1;
+    if (x_val >= y_val) {
+        x_val = x_val - y_val;
+        r = r | 1;
+    }
+    x_val = x_val << 1;
+}
+
+// Rounds and packs the quotient r; x_val is the final partial remainder
+static inline sc_uint<32> ieee754_div_round(sc_uint<32> r, sc_uint<32> x_val, sc_uint<8> result_exp, bool result_sign) {
+    bool odd, rnd, sticky;
+    sc_uint<8> shift;
+
+    sticky = (x_val != 0);
+
+    // Handle normal/overflow/underflow cases
+    if ((result_exp >= 1) && (result_exp <= 254)) { // Normal case
+        rnd = (r & 0x1000000) >> 24;
+        odd = (r & 0x2) != 0;
+        r = (r >> 1) + (rnd & (sticky | odd));
+        r = (result_exp << 23) + (r - 0x00800000);
+    }
+    else if (result_exp > 254) { // Overflow to infinity
+        r = 0x7F800000;
+    }
+    else { // Underflow (zero or subnormal)
+        shift = 1 - result_exp;
+        if (shift > 25) shift = 25;
+        sticky = sticky | ((r & ~(~0 << shift)) != 0);
+        r = r >> shift;
+        rnd = (r & 0x1000000) >> 24;
+        odd = (r & 0x2) != 0;
+        r = (r >> 1) + (rnd & (sticky | odd));
+    }
+
+    // Combine sign bit
+    return r | (result_sign ? 0x80000000 : 0);
+}
+
 // ComputeModule: Performs floating-point division (combinatorial version)
 SC_MODULE(ComputeModule) {
     sc_in<sc_uint<32>> a_significand, b_significand;
@@ -52,9 +96,7 @@ SC_MODULE(ComputeModule) {
             sc_uint<32> r;
             sc_uint<8> result_exp;
             sc_uint<5> i;
-            bool odd, rnd, sticky;
             sc_uint<32> x_val, y_val;
-            sc_uint<8> shift;
             bool result_sign;
 
             // Compute sign of the result
@@ -74,41 +116,12 @@ SC_MODULE(ComputeModule) {
 
             // Perform division (restoring algorithm) - COMBINATORIAL VERSION
             r = 0;
-            for (i = 0; i < 25; i++) {
-                r = r << 1;
-                if (x_val >= y_val) {
-                    x_val = x_val - y_val;
-                    r = r | 1;
-                }
-                x_val = x_val << 1;
+            for (i = 0; i < IEEE754_DIV_ITERATIONS; i++) {
+                ieee754_div_step(x_val, r, y_val);
                 // NO wait() in SC_METHOD - all iterations happen in one clock cycle
             }
 
-            sticky = (x_val != 0);
-            
-            // Handle normal/overflow/underflow cases
-            if ((result_exp >= 1) && (result_exp <= 254)) { // Normal case
-                rnd = (r & 0x1000000) >> 24;
-                odd = (r & 0x2) != 0;
-                r = (r >> 1) + (rnd & (sticky | odd));
-                r = (result_exp << 23) + (r - 0x00800000);
-            } 
-            else if (result_exp > 254) { // Overflow to infinity
-                r = 0x7F800000;
-            } 
-            else { // Underflow (zero or subnormal)
-                shift = 1 - result_exp;
-                if (shift > 25) shift = 25;
-                sticky = sticky | ((r & ~(~0 << shift)) != 0);
-                r = r >> shift;
-                rnd = (r & 0x1000000) >> 24;
-                odd = (r & 0x2) != 0;
-                r = (r >> 1) + (rnd & (sticky | odd));
-            }
-
-            // Combine sign bit
-            r = r | (result_sign ? 0x80000000 : 0);
-            result.write(r);
+            result.write(ieee754_div_round(r, x_val, result_exp, result_sign));
         }
     }
 
@@ -157,4 +170,109 @@ SC_MODULE(ieee754_div) {
         compute_module.reset(reset);
         compute_module.result(result);
     }
-};
\ No newline at end of file
+};
+
+// Pipelined version of ieee754_div: K restoring iterations per register
+// stage instead of all 25 in one combinational path. Stage 0 also extracts
+// and pre-normalizes, rounding is combinational after the last stage.
+// Accepts one division per cycle; the result and valid_out appear LATENCY
+// rising edges after valid_in, and the whole pipe holds while stall is set.
+// Results are bit-identical to ieee754_div.
+template <unsigned K>
+struct ieee754_div_pipe : public sc_module {
+    static const unsigned STAGES  = (IEEE754_DIV_ITERATIONS + K - 1) / K;
+    static const unsigned LATENCY = STAGES;
+
+    sc_in<bool> clk;
+    sc_in<bool> reset;
+    sc_in<bool> stall;
+    sc_in<bool> valid_in;
+    sc_in<sc_uint<32>> a, b;
+    sc_out<sc_uint<32>> result;
+    sc_out<bool> valid_out;
+
+    // Pipeline registers: partial remainder, divisor, quotient so far
+    sc_signal<bool> st_valid[STAGES];
+    sc_signal<sc_uint<32>> st_x[STAGES];
+    sc_signal<sc_uint<32>> st_y[STAGES];
+    sc_signal<sc_uint<32>> st_q[STAGES];
+    sc_signal<sc_uint<8>> st_exp[STAGES];
+    sc_signal<bool> st_sign[STAGES];
+
+    // Iterations first .. first + K - 1 (clipped to IEEE754_DIV_ITERATIONS)
+    void iterate(unsigned first, sc_uint<32>& x_val, sc_uint<32>& r, sc_uint<32> y_val) {
+        for (unsigned i = 0; i < K; i++) {
+            if (first + i < IEEE754_DIV_ITERATIONS) ieee754_div_step(x_val, r, y_val);
+        }
+    }
+
+    void pipe_process() {
+        for (unsigned s = 0; s < STAGES; s++) {
+            st_valid[s].write(false);
+            st_x[s].write(0);
+            st_y[s].write(0);
+            st_q[s].write(0);
+            st_exp[s].write(0);
+            st_sign[s].write(false);
+        }
+        wait();
+
+        while (true) {
+            if (!stall.read()) {
+                for (unsigned s = STAGES - 1; s > 0; s--) {
+                    sc_uint<32> x_val = st_x[s - 1].read();
+                    sc_uint<32> r = st_q[s - 1].read();
+                    iterate(s * K, x_val, r, st_y[s - 1].read());
+                    st_valid[s].write(st_valid[s - 1].read());
+                    st_x[s].write(x_val);
+                    st_y[s].write(st_y[s - 1].read());
+                    st_q[s].write(r);
+                    st_exp[s].write(st_exp[s - 1].read());
+                    st_sign[s].write(st_sign[s - 1].read());
+                }
+
+                // Stage 0: ExtractModule, then ComputeModule's pre-normalization
+                sc_uint<8> a_exp = (a.read() & 0x7F800000) >> 23;
+                sc_uint<8> b_exp = (b.read() & 0x7F800000) >> 23;
+                sc_uint<32> x_val = (a.read() & 0x007FFFFF) | 0x00800000;
+                sc_uint<32> y_val = (b.read() & 0x007FFFFF) | 0x00800000;
+                sc_uint<8> result_exp = a_exp - b_exp + 127;
+                if (x_val < y_val) {
+                    x_val = x_val << 1;
+                    result_exp = result_exp - 1;
+                }
+                sc_uint<32> r = 0;
+                iterate(0, x_val, r, y_val);
+                st_valid[0].write(valid_in.read());
+                st_x[0].write(x_val);
+                st_y[0].write(y_val);
+                st_q[0].write(r);
+                st_exp[0].write(result_exp);
+                st_sign[0].write(((a.read() ^ b.read()) & 0x80000000) != 0);
+            }
+            wait();
+        }
+    }
+
+    void output_process() {
+        if (reset.read()) {
+            result.write(0);
+            valid_out.write(false);
+        } else {
+            result.write(ieee754_div_round(st_q[STAGES - 1].read(), st_x[STAGES - 1].read(),
+                                           st_exp[STAGES - 1].read(), st_sign[STAGES - 1].read()));
+            valid_out.write(st_valid[STAGES - 1].read());
+        }
+    }
+
+    SC_HAS_PROCESS(ieee754_div_pipe);
+
+    ieee754_div_pipe(sc_module_name name) : sc_module(name) {
+        SC_CTHREAD(pipe_process, clk.pos());
+        reset_signal_is(reset, true);
+
+        SC_METHOD(output_process);
+        sensitive << reset << st_valid[STAGES - 1] << st_x[STAGES - 1] << st_q[STAGES - 1]
+                  << st_exp[STAGES - 1] << st_sign[STAGES - 1];
+    }
+};
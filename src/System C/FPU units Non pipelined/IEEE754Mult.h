@@ -152,5 +152,171 @@ SC_MODULE(ieee754mult) {
     }
 };
 
+// Pipelined significand multiplier laid out for Zynq DSP48E1 slices.
+// A 24x24 product does not fit one 25x18 signed DSP multiplier, so B is
+// split at bit 17: A * B[16:0] and A * B[23:17] each take one slice, and
+// the upper partial product joins through the PCIN cascade, whose fixed
+// 17-bit shift is exactly the split. STAGES picks the registers:
+//   1: P only (the sum is registered, like Temp_Mantissa leaving this unit)
+//   2: M + P  (partial products registered, the DSP48 MREG)
+//   3: A/B + M + P (operand registers, the DSP48 AREG/BREG)
+// Exponent, sign and valid travel alongside; outputs appear STAGES rising
+// edges after the inputs, one multiply per cycle.
+template <unsigned STAGES>
+struct FloatingPointMultiplierPipe : public sc_module {
+    static_assert(STAGES >= 1 && STAGES <= 3, "FloatingPointMultiplierPipe has 1 to 3 register stages");
+    static const unsigned LATENCY = STAGES;
 
+    sc_in<bool> clk;
+    sc_in<bool> reset;
+    sc_in<bool> stall;
+    sc_in<bool> valid_in;
+    sc_in<sc_uint<24>> A_Mantissa;
+    sc_in<sc_uint<24>> B_Mantissa;
+    sc_in<sc_uint<8>> A_Exponent;
+    sc_in<sc_uint<8>> B_Exponent;
+    sc_in<bool> A_sign;
+    sc_in<bool> B_sign;
+    sc_out<sc_uint<48>> Temp_Mantissa;
+    sc_out<sc_uint<8>> Temp_Exponent;
+    sc_out<bool> Sign;
+    sc_out<bool> valid_out;
+
+    // Operand registers (STAGES == 3)
+    sc_uint<24> a_reg, b_reg;
+    sc_uint<8> a_exp_reg;
+    bool a_sign_reg, a_valid_reg;
+
+    // Partial-product registers (STAGES >= 2)
+    sc_uint<41> m_lo;
+    sc_uint<31> m_hi;
+    sc_uint<8> m_exp;
+    bool m_sign, m_valid;
+
+    void pipe_process() {
+        a_reg = 0; b_reg = 0; a_exp_reg = 0; a_sign_reg = false; a_valid_reg = false;
+        m_lo = 0; m_hi = 0; m_exp = 0; m_sign = false; m_valid = false;
+        Temp_Mantissa.write(0);
+        Temp_Exponent.write(0);
+        Sign.write(false);
+        valid_out.write(false);
+        wait();
+
+        while (true) {
+            if (!stall.read()) {
+                sc_uint<8> exp_in = A_Exponent.read() + B_Exponent.read() - 127;
+                bool sign_in = A_sign.read() ^ B_sign.read();
+
+                // Operands reaching the multipliers this cycle
+                sc_uint<24> a = STAGES >= 3 ? a_reg : A_Mantissa.read();
+                sc_uint<24> b = STAGES >= 3 ? b_reg : B_Mantissa.read();
+                sc_uint<8> a_exp = STAGES >= 3 ? a_exp_reg : exp_in;
+                bool a_sign = STAGES >= 3 ? a_sign_reg : sign_in;
+                bool a_valid = STAGES >= 3 ? a_valid_reg : valid_in.read();
+
+                sc_uint<41> lo = a * b.range(16, 0);
+                sc_uint<31> hi = a * b.range(23, 17);
+
+                // Post-adder: the cascade adds the upper product shifted by 17
+                if (STAGES >= 2) {
+                    Temp_Mantissa.write(sc_uint<48>(m_lo) + (sc_uint<48>(m_hi) << 17));
+                    Temp_Exponent.write(m_exp);
+                    Sign.write(m_sign);
+                    valid_out.write(m_valid);
+                    m_lo = lo;
+                    m_hi = hi;
+                    m_exp = a_exp;
+                    m_sign = a_sign;
+                    m_valid = a_valid;
+                } else {
+                    Temp_Mantissa.write(sc_uint<48>(lo) + (sc_uint<48>(hi) << 17));
+                    Temp_Exponent.write(a_exp);
+                    Sign.write(a_sign);
+                    valid_out.write(a_valid);
+                }
+
+                if (STAGES >= 3) {
+                    a_reg = A_Mantissa.read();
+                    b_reg = B_Mantissa.read();
+                    a_exp_reg = exp_in;
+                    a_sign_reg = sign_in;
+                    a_valid_reg = valid_in.read();
+                }
+            }
+            wait();
+        }
+    }
+
+    SC_HAS_PROCESS(FloatingPointMultiplierPipe);
+
+    FloatingPointMultiplierPipe(sc_module_name name) : sc_module(name) {
+        SC_CTHREAD(pipe_process, clk.pos());
+        reset_signal_is(reset, true);
+    }
+};
+
+// ieee754mult with FloatingPointMultiplierPipe in place of the combinational
+// FloatingPointMultiplier. Extraction and normalization stay combinational
+// around it; result and valid_out follow valid_in by LATENCY rising edges.
+// Results are bit-identical to ieee754mult.
+template <unsigned STAGES>
+struct ieee754mult_pipe : public sc_module {
+    static const unsigned LATENCY = STAGES;
+
+    sc_in<bool> clk;
+    sc_in<bool> reset;
+    sc_in<bool> stall;
+    sc_in<bool> valid_in;
+    sc_in<sc_uint<32>> A;
+    sc_in<sc_uint<32>> B;
+    sc_out<sc_uint<32>> result;
+    sc_out<bool> valid_out;
+
+    // Internal signals
+    sc_signal<bool> A_sign, B_sign, Sign;
+    sc_signal<sc_uint<8>> A_Exponent, B_Exponent, Temp_Exponent;
+    sc_signal<sc_uint<24>> A_Mantissa, B_Mantissa;
+    sc_signal<sc_uint<48>> Temp_Mantissa;
+
+    // Submodule instances
+    FloatingPointExtractor extractA;
+    FloatingPointExtractor extractB;
+    FloatingPointMultiplierPipe<STAGES> multiply;
+    FloatingPointNormalizer normalize;
+
+    ieee754mult_pipe(sc_module_name name)
+        : sc_module(name), extractA("extractA"), extractB("extractB"), multiply("multiply"), normalize("normalize") {
+        extractA.in(A);
+        extractA.reset(reset);
+        extractA.sign(A_sign);
+        extractA.exponent(A_Exponent);
+        extractA.mantissa(A_Mantissa);
+
+        extractB.in(B);
+        extractB.reset(reset);
+        extractB.sign(B_sign);
+        extractB.exponent(B_Exponent);
+        extractB.mantissa(B_Mantissa);
 
+        multiply.clk(clk);
+        multiply.reset(reset);
+        multiply.stall(stall);
+        multiply.valid_in(valid_in);
+        multiply.A_Mantissa(A_Mantissa);
+        multiply.B_Mantissa(B_Mantissa);
+        multiply.A_Exponent(A_Exponent);
+        multiply.B_Exponent(B_Exponent);
+        multiply.A_sign(A_sign);
+        multiply.B_sign(B_sign);
+        multiply.Temp_Mantissa(Temp_Mantissa);
+        multiply.Temp_Exponent(Temp_Exponent);
+        multiply.Sign(Sign);
+        multiply.valid_out(valid_out);
+
+        normalize.Temp_Mantissa(Temp_Mantissa);
+        normalize.Temp_Exponent(Temp_Exponent);
+        normalize.Sign(Sign);
+        normalize.reset(reset);
+        normalize.result(result);
+    }
+};
@@ -32,7 +32,10 @@ SC_MODULE(ieee754_subtractor) {
             
             // Align the smaller number
             aligned = (sc_uint<24>(1) << 23) | val_s.range(22,0);
-            aligned >>= (val_b.range(30,23) - val_s.range(30,23));
+            // A shift of 24 or more leaves nothing, as in FPU.sv; the host
+            // shift would wrap at 64
+            sc_uint<8> shift = val_b.range(30,23) - val_s.range(30,23);
+            aligned = (shift > 23) ? sc_uint<24>(0) : sc_uint<24>(aligned >> shift);
             
             // Perform subtraction or addition based on sign
             if (sig_a == sig_b) {
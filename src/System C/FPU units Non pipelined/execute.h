@@ -1,3 +1,23 @@
+// Building with -DFPU_DIV_ITERS_PER_STAGE=K replaces the single-cycle
+// divider with ieee754_div_pipe<K>, and -DFPU_MUL_STAGES=N the single-cycle
+// multiplier with ieee754mult_pipe<N>. Every instruction then spends
+// EXEC_LATENCY + 1 cycles in Execute, EXEC_LATENCY being the longer of the
+// two pipes, so results still leave in order and one instruction is
+// accepted per cycle. Without either, Execute is one cycle. busy is set
+// while an instruction is inside Execute and not yet on valid_out, so the
+// IFU knows when the pipeline has drained.
+//
+// The units are operand-isolated: op1/op2 only reach the unit the opcode
+// selects, the others see zeros and stay idle, and the subtractor is only
+// enabled for fsub. -DFPU_NO_OPERAND_ISOLATION passes op1/op2 to all of
+// them again, for comparing toggles and simulation speed; the toggles are
+// only counted with -DFPU_COUNT_TOGGLES. With -DFPU_SHARED_ADDSUB, fadd.s
+// and fsub.s share one ieee754_addsub instead of the adder and subtractor
+// FPU.sv was generated from.
+#if defined(FPU_DIV_ITERS_PER_STAGE) || defined(FPU_MUL_STAGES)
+#define FPU_EXECUTE_PIPELINED
+#endif
+
 SC_MODULE(Execute) {
     // Port declarations
     sc_in<bool> clk;
@@ -16,23 +36,261 @@ SC_MODULE(Execute) {
     sc_out<bool> reg_write_out;
     sc_out<bool> valid_out;
     sc_out<sc_uint<32>> instruction_out;
+    sc_out<bool> busy;
+#ifndef __SC_TOOL__
+    // Fetch address of the instruction, for the commit log
+    sc_in<sc_uint<32>> pc_in;
+    sc_out<sc_uint<32>> pc_out;
+#endif
 
     // Internal signals
+#ifdef FPU_SHARED_ADDSUB
+    sc_signal<sc_uint<32>> fp_addsub_result;
+    sc_signal<bool> addsub_sub;
+
+    static const unsigned UNIT_ADD = 0;
+    static const unsigned UNIT_SUB = 0;
+    static const unsigned UNIT_MUL = 1;
+    static const unsigned UNIT_DIV = 2;
+    static const unsigned NUM_UNITS = 3;
+#else
     sc_signal<sc_uint<32>> fp_add_result;
     sc_signal<sc_uint<32>> fp_sub_result;
+    sc_signal<bool> sub_enable;
+
+    static const unsigned UNIT_ADD = 0;
+    static const unsigned UNIT_SUB = 1;
+    static const unsigned UNIT_MUL = 2;
+    static const unsigned UNIT_DIV = 3;
+    static const unsigned NUM_UNITS = 4;
+#endif
     sc_signal<sc_uint<32>> fp_mul_result;
     sc_signal<sc_uint<32>> fp_div_result;
-    sc_signal<bool> sub_enable;
+
+    // Operands per unit
+    sc_signal<sc_uint<32>> unit_a[NUM_UNITS];
+    sc_signal<sc_uint<32>> unit_b[NUM_UNITS];
+
+    void isolate_process() {
+        bool valid = valid_in.read();
+        sc_uint<7> op = opcode.read();
+        bool sel[NUM_UNITS];
+        for (unsigned u = 0; u < NUM_UNITS; u++) sel[u] = false;
+        sel[UNIT_ADD] = sel[UNIT_ADD] || (valid && op == 0x00);
+        sel[UNIT_SUB] = sel[UNIT_SUB] || (valid && op == 0x04);
+        sel[UNIT_MUL] = valid && op == 0x08;
+        sel[UNIT_DIV] = valid && op == 0x0C;
+#ifdef FPU_NO_OPERAND_ISOLATION
+        for (unsigned u = 0; u < NUM_UNITS; u++) sel[u] = true;
+#endif
+        for (unsigned u = 0; u < NUM_UNITS; u++) {
+            unit_a[u].write(sel[u] ? op1.read() : sc_uint<32>(0));
+            unit_b[u].write(sel[u] ? op2.read() : sc_uint<32>(0));
+        }
+#ifdef FPU_SHARED_ADDSUB
+        addsub_sub.write(valid && op == 0x04);
+#else
+        sub_enable.write(sel[UNIT_SUB]);
+#endif
+    }
+
+    sc_uint<32> add_sub_result(sc_uint<7> op) {
+#ifdef FPU_SHARED_ADDSUB
+        return fp_addsub_result.read();
+#else
+        return op == 0x04 ? fp_sub_result.read() : fp_add_result.read();
+#endif
+    }
+
+#ifdef FPU_COUNT_TOGGLES
+    // Bits flipped on the units' operand inputs, summed over all units.
+    // Sensitive to every unit input, so only built for
+    // compare_operand_isolation.sh (-DFPU_COUNT_TOGGLES)
+    uint64_t operand_toggles;
+    uint32_t toggle_a[NUM_UNITS];
+    uint32_t toggle_b[NUM_UNITS];
+
+    void toggle_process() {
+        for (unsigned u = 0; u < NUM_UNITS; u++) {
+            uint32_t a = unit_a[u].read().to_uint(), b = unit_b[u].read().to_uint();
+            operand_toggles += __builtin_popcount(a ^ toggle_a[u]) + __builtin_popcount(b ^ toggle_b[u]);
+            toggle_a[u] = a;
+            toggle_b[u] = b;
+        }
+    }
+#endif
 
     // Submodules
+#ifdef FPU_SHARED_ADDSUB
+    ieee754_addsub* fp_addsub;
+#else
     ieee754_adder* fp_adder;
     ieee754_subtractor* fp_subtractor;
+#endif
+#ifdef FPU_MUL_STAGES
+    static const unsigned MUL_LATENCY = ieee754mult_pipe<FPU_MUL_STAGES>::LATENCY;
+
+    ieee754mult_pipe<FPU_MUL_STAGES>* fp_multiplier;
+    sc_signal<bool> mul_issue;
+    sc_signal<bool> mul_valid;
+#else
+    static const unsigned MUL_LATENCY = 0;
+
     ieee754mult* fp_multiplier;
+#endif
+#ifdef FPU_DIV_ITERS_PER_STAGE
+    static const unsigned DIV_LATENCY = ieee754_div_pipe<FPU_DIV_ITERS_PER_STAGE>::LATENCY;
+
+    ieee754_div_pipe<FPU_DIV_ITERS_PER_STAGE>* fp_divider;
+    sc_signal<bool> div_issue;
+    sc_signal<bool> div_valid;
+#else
+    static const unsigned DIV_LATENCY = 0;
+
     ieee754_div* fp_divider;
+#endif
+
+#ifdef FPU_EXECUTE_PIPELINED
+    static const unsigned EXEC_LATENCY = DIV_LATENCY > MUL_LATENCY ? DIV_LATENCY : MUL_LATENCY;
+
+    // Instructions travelling alongside the multiplier and divider pipes.
+    // A pipelined unit's result is taken when it raises valid_out, into the
+    // oldest instruction waiting on it; EXEC_LATENCY only sets how long
+    // every instruction stays, so results leave in order.
+    bool pend_valid[EXEC_LATENCY];
+    bool pend_reg_write[EXEC_LATENCY];
+    sc_uint<7> pend_opcode[EXEC_LATENCY];
+    sc_uint<5> pend_rd[EXEC_LATENCY];
+    sc_uint<32> pend_instruction[EXEC_LATENCY];
+    sc_uint<32> pend_result[EXEC_LATENCY];
+    bool pend_done[EXEC_LATENCY];
+#ifndef __SC_TOOL__
+    sc_uint<32> pend_pc[EXEC_LATENCY];
+#endif
+
+    void issue_process() {
+        bool issue = valid_in.read() && reg_write_in.read();
+#ifdef FPU_MUL_STAGES
+        mul_issue.write(issue && opcode.read() == 0x08);
+#endif
+#ifdef FPU_DIV_ITERS_PER_STAGE
+        div_issue.write(issue && opcode.read() == 0x0C);
+#endif
+    }
+
+    // Whether op goes to a pipelined unit, whose result comes back later
+    bool unit_piped(sc_uint<7> op) {
+#ifdef FPU_MUL_STAGES
+        if (op == 0x08) return true;
+#endif
+#ifdef FPU_DIV_ITERS_PER_STAGE
+        if (op == 0x0C) return true;
+#endif
+        return false;
+    }
+
+    // Result of an instruction entering Execute from a single-cycle unit
+    sc_uint<32> entry_result(sc_uint<7> op) {
+        if (op == 0x00 || op == 0x04) return add_sub_result(op);
+        if (op == 0x08) return fp_mul_result.read();
+        if (op == 0x0C) return fp_div_result.read();
+        return 0;
+    }
+
+    // The units keep issue order, so a valid_out answers the oldest
+    // instruction still waiting on that unit
+    void unit_retire(sc_uint<7> op, sc_uint<32> result) {
+        bool taken = false;
+        for (unsigned s = EXEC_LATENCY; s > 0; s--) {
+            unsigned i = s - 1;
+            if (!taken && pend_valid[i] && pend_reg_write[i] && !pend_done[i] && pend_opcode[i] == op) {
+                pend_result[i] = result;
+                pend_done[i] = true;
+                taken = true;
+            }
+        }
+    }
 
     void execute_process() {
-        // Initialize constants
-        sub_enable.write(true);
+        for (unsigned s = 0; s < EXEC_LATENCY; s++) {
+            pend_valid[s] = false;
+            pend_reg_write[s] = false;
+            pend_opcode[s] = 0;
+            pend_rd[s] = 0;
+            pend_instruction[s] = 0;
+            pend_result[s] = 0;
+            pend_done[s] = false;
+#ifndef __SC_TOOL__
+            pend_pc[s] = 0;
+#endif
+        }
+        busy.write(false);
+        wait();
+
+        while (true) {
+            if (reset.read()) {
+                result_out.write(0);
+                rd_out.write(0);
+                reg_write_out.write(false);
+                valid_out.write(false);
+                instruction_out.write(0);
+                busy.write(false);
+#ifndef __SC_TOOL__
+                pc_out.write(0);
+#endif
+            }
+            else if (!stall.read()) {
+                const unsigned last = EXEC_LATENCY - 1;
+#ifdef FPU_MUL_STAGES
+                if (mul_valid.read()) unit_retire(0x08, fp_mul_result.read());
+#endif
+#ifdef FPU_DIV_ITERS_PER_STAGE
+                if (div_valid.read()) unit_retire(0x0C, fp_div_result.read());
+#endif
+                valid_out.write(pend_valid[last]);
+                rd_out.write(pend_rd[last]);
+                reg_write_out.write(pend_reg_write[last]);
+                instruction_out.write(pend_instruction[last]);
+#ifndef __SC_TOOL__
+                pc_out.write(pend_pc[last]);
+#endif
+                if (pend_valid[last] && pend_reg_write[last])
+                    result_out.write(pend_result[last]);
+
+                for (unsigned s = last; s > 0; s--) {
+                    pend_valid[s] = pend_valid[s - 1];
+                    pend_reg_write[s] = pend_reg_write[s - 1];
+                    pend_opcode[s] = pend_opcode[s - 1];
+                    pend_rd[s] = pend_rd[s - 1];
+                    pend_instruction[s] = pend_instruction[s - 1];
+                    pend_result[s] = pend_result[s - 1];
+                    pend_done[s] = pend_done[s - 1];
+#ifndef __SC_TOOL__
+                    pend_pc[s] = pend_pc[s - 1];
+#endif
+                }
+                pend_valid[0] = valid_in.read();
+                pend_reg_write[0] = reg_write_in.read();
+                pend_opcode[0] = opcode.read();
+                pend_rd[0] = rd_in.read();
+                pend_instruction[0] = instruction_in.read();
+                pend_done[0] = !unit_piped(opcode.read());
+                pend_result[0] = pend_done[0] ? entry_result(opcode.read()) : sc_uint<32>(0);
+#ifndef __SC_TOOL__
+                pend_pc[0] = pc_in.read();
+#endif
+
+                bool in_flight = false;
+                for (unsigned s = 0; s < EXEC_LATENCY; s++) in_flight = in_flight || pend_valid[s];
+                busy.write(in_flight);
+            }
+            wait();
+        }
+    }
+#else
+    // Results leave on the edge after they enter, so never busy
+    void execute_process() {
+        busy.write(false);
         wait();
         
         while (true) {
@@ -42,17 +300,23 @@ SC_MODULE(Execute) {
                 reg_write_out.write(false);
                 valid_out.write(false);
                 instruction_out.write(0);
+#ifndef __SC_TOOL__
+                pc_out.write(0);
+#endif
             }
             else if (!stall.read()) {
                 valid_out.write(valid_in.read());
                 rd_out.write(rd_in.read());
                 reg_write_out.write(reg_write_in.read());
                 instruction_out.write(instruction_in.read());
+#ifndef __SC_TOOL__
+                pc_out.write(pc_in.read());
+#endif
                 
                 if (valid_in.read() && reg_write_in.read()) {
                     switch(opcode.read()) {
-                        case 0x00: result_out.write(fp_add_result.read()); break;
-                        case 0x04: result_out.write(fp_sub_result.read()); break;
+                        case 0x00:
+                        case 0x04: result_out.write(add_sub_result(opcode.read())); break;
                         case 0x08: result_out.write(fp_mul_result.read()); break;
                         case 0x0C: result_out.write(fp_div_result.read()); break;
                         default: result_out.write(0); break;
@@ -62,34 +326,91 @@ SC_MODULE(Execute) {
             wait();
         }
     }
+#endif
 
+#ifdef FPU_SHARED_ADDSUB
+    SC_CTOR(Execute) : addsub_sub("addsub_sub") {
+#else
     SC_CTOR(Execute) : sub_enable("sub_enable") {
+#endif
+#ifdef FPU_SHARED_ADDSUB
+        // Create and connect fp_addsub
+        fp_addsub = new ieee754_addsub("fp_addsub");
+        fp_addsub->A(unit_a[UNIT_ADD]);
+        fp_addsub->B(unit_b[UNIT_ADD]);
+        fp_addsub->sub(addsub_sub);
+        fp_addsub->O(fp_addsub_result);
+#else
         // Create and connect fp_adder
         fp_adder = new ieee754_adder("fp_adder");
-        fp_adder->A(op1);
-        fp_adder->B(op2);
+        fp_adder->A(unit_a[UNIT_ADD]);
+        fp_adder->B(unit_b[UNIT_ADD]);
         fp_adder->O(fp_add_result);
 
         // Create and connect fp_subtractor
         fp_subtractor = new ieee754_subtractor("fp_subtractor");
-        fp_subtractor->a(op1);
-        fp_subtractor->b(op2);
+        fp_subtractor->a(unit_a[UNIT_SUB]);
+        fp_subtractor->b(unit_b[UNIT_SUB]);
         fp_subtractor->enable(sub_enable);
         fp_subtractor->ans(fp_sub_result);
+#endif
 
         // Create and connect fp_multiplier
+#ifdef FPU_MUL_STAGES
+        fp_multiplier = new ieee754mult_pipe<FPU_MUL_STAGES>("fp_multiplier");
+        fp_multiplier->clk(clk);
+        fp_multiplier->reset(reset);
+        fp_multiplier->stall(stall);
+        fp_multiplier->valid_in(mul_issue);
+        fp_multiplier->A(unit_a[UNIT_MUL]);
+        fp_multiplier->B(unit_b[UNIT_MUL]);
+        fp_multiplier->result(fp_mul_result);
+        fp_multiplier->valid_out(mul_valid);
+#else
         fp_multiplier = new ieee754mult("fp_multiplier");
-        fp_multiplier->A(op1);
-        fp_multiplier->B(op2);
+        fp_multiplier->A(unit_a[UNIT_MUL]);
+        fp_multiplier->B(unit_b[UNIT_MUL]);
         fp_multiplier->reset(reset);
         fp_multiplier->result(fp_mul_result);
+#endif
 
+#ifdef FPU_DIV_ITERS_PER_STAGE
+        fp_divider = new ieee754_div_pipe<FPU_DIV_ITERS_PER_STAGE>("fp_divider");
+        fp_divider->clk(clk);
+        fp_divider->reset(reset);
+        fp_divider->stall(stall);
+        fp_divider->valid_in(div_issue);
+        fp_divider->a(unit_a[UNIT_DIV]);
+        fp_divider->b(unit_b[UNIT_DIV]);
+        fp_divider->result(fp_div_result);
+        fp_divider->valid_out(div_valid);
+#else
         // Create and connect fp_divider (updated interface)
         fp_divider = new ieee754_div("fp_divider");
-        fp_divider->a(op1);
-        fp_divider->b(op2);
+        fp_divider->a(unit_a[UNIT_DIV]);
+        fp_divider->b(unit_b[UNIT_DIV]);
         fp_divider->reset(reset);
         fp_divider->result(fp_div_result);
+#endif
+
+        SC_METHOD(isolate_process);
+        sensitive << valid_in << opcode << op1 << op2;
+
+#ifdef FPU_COUNT_TOGGLES
+        operand_toggles = 0;
+        for (unsigned u = 0; u < NUM_UNITS; u++) {
+            toggle_a[u] = 0;
+            toggle_b[u] = 0;
+        }
+        SC_METHOD(toggle_process);
+        for (unsigned u = 0; u < NUM_UNITS; u++) sensitive << unit_a[u] << unit_b[u];
+        dont_initialize();
+#endif
+
+#ifdef FPU_EXECUTE_PIPELINED
+        SC_METHOD(issue_process);
+        sensitive << valid_in << reg_write_in << opcode;
+#endif
 
         SC_CTHREAD(execute_process, clk.pos());
         reset_signal_is(reset, true);
@@ -100,11 +421,19 @@ SC_MODULE(Execute) {
         reg_write_out.initialize(false);
         valid_out.initialize(false);
         instruction_out.initialize(0);
+        busy.initialize(false);
+#ifndef __SC_TOOL__
+        pc_out.initialize(0);
+#endif
     }
 
     ~Execute() {
+#ifdef FPU_SHARED_ADDSUB
+        delete fp_addsub;
+#else
         delete fp_adder;
         delete fp_subtractor;
+#endif
         delete fp_multiplier;
         delete fp_divider;
     }
@@ -1,23 +1,181 @@
-// Separate instruction memory module
-SC_MODULE(InstructionMemory) {
+#include <systemc.h>
+#ifndef __SC_TOOL__
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Instruction memory of WORDS 32-bit words, word-addressed by address[.:2]
+// and wrapping at the end. The words are a plain array rather than one
+// signal each, so the memory costs the kernel one process however deep it
+// is; the testbench fills it through the backdoor (load, write_word,
+// load_binary, load_hex) instead of writing signals.
+//
+// For ICSC the words stay a signal array, as in the memory FPU.sv was
+// generated from. Nothing in the design drives it, so it comes out as a
+// plain imem array that the SystemVerilog and Verilator testbenches load
+// by hierarchical reference (imem.imem).
+//
+// With REGISTERED the read port is a BRAM: instruction takes the word at
+// address on the rising edge (held while stall is high), one cycle after
+// the combinational port would show it. The IFU presents the next PC
+// instead of the current one then, so the fetch stream is the same.
+template <unsigned WORDS, bool REGISTERED>
+struct InstructionMemory_t : public sc_module {
+    static_assert(WORDS >= 2 && (WORDS & (WORDS - 1)) == 0, "InstructionMemory_t depth must be a power of two");
+    static const unsigned DEPTH = WORDS;
+    static const bool     READ_REGISTERED = REGISTERED;
+
+    sc_in<bool> clk;
+    sc_in<bool> stall;
     sc_in<sc_uint<32>> address;
     sc_out<sc_uint<32>> instruction;
-    
-    // Instruction memory array
-    sc_signal<sc_uint<32>> imem[256];
-    
+
+#ifdef __SC_TOOL__
+    sc_signal<sc_uint<32>> imem[WORDS];
+
+    sc_uint<32> word(unsigned index) { return imem[index].read(); }
+#else
+    uint32_t imem[WORDS];
+
+    sc_uint<32> word(unsigned index) { return imem[index]; }
+#endif
+
+    unsigned word_index() const { return (unsigned)(address.read().to_uint() >> 2) & (WORDS - 1); }
+
+    // Word last latched by the registered port
+    unsigned latched;
+
     void process_read() {
-        // Read from instruction memory based on address (word-aligned)
-        instruction.write(imem[address.read().range(9,2)].read());
+#ifndef __SC_TOOL__
+        if (REGISTERED) {
+            // Also woken by backdoor loads, which land between clock edges
+            // and show on the port as if the memory had always held them
+            if (clk.posedge() && !stall.read()) latched = word_index();
+            instruction.write(word(latched));
+            return;
+        }
+#endif
+        instruction.write(word(word_index()));
+    }
+
+#ifdef __SC_TOOL__
+    void read_thread() {
+        while (true) {
+            if (!stall.read()) {
+                latched = word_index();
+                instruction.write(word(latched));
+            }
+            wait();
+        }
+    }
+#else
+    sc_event loaded;
+
+    // Copies n words to word index first onwards. False, with nothing
+    // written, if they do not fit.
+    bool load(const uint32_t* words, size_t n, size_t first = 0) {
+        if (first > WORDS || n > WORDS - first) return false;
+        std::memcpy(imem + first, words, n * sizeof(uint32_t));
+        loaded.notify(SC_ZERO_TIME);
+        return true;
     }
-    
-    // No initialization - will be done by testbench
-    
-    SC_CTOR(InstructionMemory) {
+
+    void write_word(unsigned index, uint32_t word) {
+        imem[index & (WORDS - 1)] = word;
+        loaded.notify(SC_ZERO_TIME);
+    }
+
+    uint32_t read_word(unsigned index) const { return imem[index & (WORDS - 1)]; }
+
+    void clear() {
+        std::memset(imem, 0, sizeof(imem));
+        loaded.notify(SC_ZERO_TIME);
+    }
+
+    // Raw little-endian words, mapped rather than read
+    bool load_binary(const std::string& path, std::string& error) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) { error = "cannot open " + path; return false; }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size % 4 != 0) {
+            close(fd);
+            error = path + " is not a whole number of words";
+            return false;
+        }
+        size_t n = (size_t)st.st_size / 4;
+        if (n > WORDS) {
+            close(fd);
+            error = path + ": " + std::to_string(n) + " words, the memory holds " + std::to_string(WORDS);
+            return false;
+        }
+        if (n) {
+            void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) { close(fd); error = "cannot mmap " + path; return false; }
+            load(static_cast<const uint32_t*>(p), n);
+            munmap(p, st.st_size);
+        }
+        close(fd);
+        return true;
+    }
+
+    // $readmemh format: hex words separated by white space, @index to move
+    // on, // comments
+    bool load_hex(const std::string& path, std::string& error) {
+        std::ifstream in(path.c_str());
+        if (!in) { error = "cannot open " + path; return false; }
+        std::string tok;
+        unsigned long index = 0;
+        while (in >> tok) {
+            if (tok.compare(0, 2, "//") == 0) { std::getline(in, tok); continue; }
+            bool at = tok[0] == '@';
+            char* end;
+            unsigned long v = std::strtoul(tok.c_str() + at, &end, 16);
+            if (*end || end == tok.c_str() + at) { error = path + ": bad token " + tok; return false; }
+            if (at) { index = v; continue; }
+            if (index >= WORDS) { error = path + ": word index " + std::to_string(index) + " is past the memory"; return false; }
+            imem[index++] = (uint32_t)v;
+        }
+        loaded.notify(SC_ZERO_TIME);
+        return true;
+    }
+#endif
+
+    SC_HAS_PROCESS(InstructionMemory_t);
+
+    InstructionMemory_t(sc_module_name name) : sc_module(name), latched(0) {
+#ifdef __SC_TOOL__
+        if (REGISTERED) {
+            SC_CTHREAD(read_thread, clk.pos());
+        } else {
+            SC_METHOD(process_read);
+            sensitive << address;
+            for (unsigned i = 0; i < WORDS; ++i) sensitive << imem[i];
+        }
+#else
+        for (unsigned i = 0; i < WORDS; ++i) imem[i] = 0;
         SC_METHOD(process_read);
-        sensitive << address;
-        for (int i = 0; i < 256; i++) {
-            sensitive << imem[i];
+        if (REGISTERED) {
+            sensitive << clk.pos() << loaded;
+            dont_initialize();
+        } else {
+            sensitive << address << loaded;
         }
+#endif
     }
 };
+
+// -DFPU_IMEM_WORDS=N sets the depth (a power of two, 256 by default) and
+// -DFPU_IMEM_REGISTERED gives the memory a registered read port.
+#ifndef FPU_IMEM_WORDS
+#define FPU_IMEM_WORDS 256
+#endif
+#ifdef FPU_IMEM_REGISTERED
+typedef InstructionMemory_t<FPU_IMEM_WORDS, true> InstructionMemory;
+#else
+typedef InstructionMemory_t<FPU_IMEM_WORDS, false> InstructionMemory;
+#endif
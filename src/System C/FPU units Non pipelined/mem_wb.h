@@ -12,6 +12,11 @@ SC_MODULE(Memory) {
     sc_out<bool> reg_write_out;
     sc_out<bool> valid_out;
     sc_out<sc_uint<32>> instruction_out;
+#ifndef __SC_TOOL__
+    // Fetch address of the instruction, for the commit log
+    sc_in<sc_uint<32>> pc_in;
+    sc_out<sc_uint<32>> pc_out;
+#endif
 
     void memory_process() {
         // Initialize outputs
@@ -20,6 +25,9 @@ SC_MODULE(Memory) {
         reg_write_out.write(false);
         valid_out.write(false);
         instruction_out.write(0);
+#ifndef __SC_TOOL__
+        pc_out.write(pc_in.read());
+#endif
 
         if (!reset.read() && !stall.read()) {
             result_out.write(result_in.read());
@@ -28,12 +36,9 @@ SC_MODULE(Memory) {
             valid_out.write(valid_in.read());
             instruction_out.write(instruction_in.read());
 
-            if (valid_in.read()) {
-                sc_uint<32> opcode = (instruction_in.read() >> 25) & 0x7F;
-                cout << "MEM @" << sc_time_stamp() << ": ";
-                cout << "rd=f" << rd_in.read();
-                cout << " opcode=0x" << opcode << endl;
-            }
+            if (valid_in.read())
+                FPU_LOG(SIMLOG_MEM, SIMLOG_TRACE, "rd=f%u opcode=0x%x", rd_in.read(),
+                        (instruction_in.read().to_uint() >> 25) & 0x7F);
         }
     }
 
@@ -41,12 +46,18 @@ SC_MODULE(Memory) {
         SC_METHOD(memory_process);
         sensitive << reset << stall << valid_in << result_in << rd_in
                  << reg_write_in << instruction_in;
+#ifndef __SC_TOOL__
+        sensitive << pc_in;
+#endif
         // Initialize outputs
         result_out.initialize(0);
         rd_out.initialize(0);
         reg_write_out.initialize(false);
         valid_out.initialize(false);
         instruction_out.initialize(0);
+#ifndef __SC_TOOL__
+        pc_out.initialize(0);
+#endif
     }
 };
 
@@ -78,11 +89,8 @@ SC_MODULE(Writeback) {
             reg_write_en.write(do_write);
             valid_out.write(valid_in.read());
 
-            if (do_write) {
-                sc_uint<32> opcode = (instruction_in.read() >> 25) & 0x7F;
-                cout << "WB  @" << sc_time_stamp() << ": ";
-                cout << " (opcode=0x" << opcode << ")" << endl;
-            }
+            if (do_write)
+                FPU_LOG(SIMLOG_WB, SIMLOG_TRACE, " (opcode=0x%x)", (instruction_in.read().to_uint() >> 25) & 0x7F);
         }
     }
 
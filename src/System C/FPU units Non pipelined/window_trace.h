@@ -0,0 +1,206 @@
+#ifndef WINDOW_TRACE_H
+#define WINDOW_TRACE_H
+
+// Trigger-based waveform capture, in the style of an on-chip logic analyzer.
+// Selected signals are sampled on every rising clock edge into a ring buffer
+// of the last `depth` cycles. A VCD file holding the window is written only
+// when a trigger fires: a signal reaching a value (e.g. a PC) or any user
+// predicate (exception condition, mismatch against a reference, ...).
+// A trigger fires on its rising edge, so a condition that stays true
+// produces one dump. `post` extra cycles are captured after the trigger
+// before the window is written.
+// Simulation only, never passed to ICSC.
+
+#include <systemc.h>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+template <class T> struct window_trace_width { static const int value = 64; };
+template <> struct window_trace_width<bool> { static const int value = 1; };
+template <int W> struct window_trace_width<sc_uint<W>> { static const int value = W; };
+template <int W> struct window_trace_width<sc_int<W>> { static const int value = W; };
+
+static inline uint64_t window_trace_bits(bool v) { return v; }
+template <int W> static inline uint64_t window_trace_bits(const sc_uint<W>& v) { return v.to_uint64(); }
+template <int W> static inline uint64_t window_trace_bits(const sc_int<W>& v) {
+    return (uint64_t)v.to_int64() & (W >= 64 ? ~0ULL : ((1ULL << W) - 1));
+}
+template <class T> static inline uint64_t window_trace_bits(const T& v) { return (uint64_t)v; }
+
+SC_MODULE(WindowTrace) {
+    sc_in<bool> clk;
+
+    SC_HAS_PROCESS(WindowTrace);
+
+    // Writes <prefix>_<n>.vcd for every fired trigger
+    WindowTrace(sc_module_name nm, const std::string& file_prefix, unsigned depth = 1024, unsigned post = 16)
+        : sc_module(nm), prefix(file_prefix), depth(depth ? depth : 1), post(post), max_dumps(16),
+          head(0), filled(0), post_left(0), armed(false), dump_count(0), trigger_row(0) {
+        times.resize(this->depth);
+        SC_METHOD(sample);
+        sensitive << clk.pos();
+        dont_initialize();
+    }
+
+    ~WindowTrace() {
+        for (probe_base* p : probes) delete p;
+    }
+
+    // Register a signal before simulation starts
+    template <class T>
+    void add(const sc_signal_in_if<T>& sig, const std::string& name, int width = window_trace_width<T>::value) {
+        probes.push_back(new probe<T>(sig, name, width));
+        data.assign(depth * probes.size(), 0);
+    }
+
+    void add_trigger(const std::string& name, std::function<bool()> pred) {
+        trigger_t t;
+        t.name = name;
+        t.pred = pred;
+        t.last = false;
+        triggers.push_back(t);
+    }
+
+    template <class T>
+    void trigger_on_value(const sc_signal_in_if<T>& sig, const T& value, const std::string& name) {
+        const sc_signal_in_if<T>* s = &sig;
+        add_trigger(name, [s, value]() { return s->read() == value; });
+    }
+
+    void set_max_dumps(unsigned n) { max_dumps = n; }
+    unsigned dumps() const { return dump_count; }
+
+    // Writes the current window immediately, e.g. from a failing check
+    void dump_now(const std::string& reason) {
+        if (dump_count < max_dumps) write_vcd(reason, filled ? (head + depth - 1) % depth : 0);
+    }
+
+private:
+    struct probe_base {
+        std::string name;
+        int         width;
+        probe_base(const std::string& n, int w) : name(n), width(w) {}
+        virtual ~probe_base() {}
+        virtual uint64_t sample() const = 0;
+    };
+
+    template <class T>
+    struct probe : probe_base {
+        const sc_signal_in_if<T>& sig;
+        probe(const sc_signal_in_if<T>& s, const std::string& n, int w) : probe_base(n, w), sig(s) {}
+        uint64_t sample() const { return window_trace_bits(sig.read()); }
+    };
+
+    struct trigger_t {
+        std::string           name;
+        std::function<bool()> pred;
+        bool                  last;
+    };
+
+    std::string              prefix;
+    unsigned                 depth;
+    unsigned                 post;
+    unsigned                 max_dumps;
+    std::vector<probe_base*> probes;
+    std::vector<trigger_t>   triggers;
+    std::vector<uint64_t>    data;      // depth x probes, row per cycle
+    std::vector<uint64_t>    times;     // sample time in ps
+    unsigned                 head;      // next row to write
+    unsigned                 filled;
+    unsigned                 post_left;
+    bool                     armed;     // trigger seen, capturing post-trigger cycles
+    unsigned                 dump_count;
+    unsigned                 trigger_row;
+    std::string              trigger_name;
+
+    void sample() {
+        size_t n = probes.size();
+        uint64_t* row = data.data() + head * n;
+        for (size_t i = 0; i < n; ++i) row[i] = probes[i]->sample();
+        times[head] = (uint64_t)(sc_time_stamp().to_seconds() * 1e12 + 0.5);
+        unsigned cur = head;
+        head = (head + 1) % depth;
+        if (filled < depth) ++filled;
+
+        for (trigger_t& t : triggers) {
+            bool v = t.pred();
+            if (v && !t.last && !armed && dump_count < max_dumps) {
+                armed        = true;
+                post_left    = post;
+                trigger_row  = cur;
+                trigger_name = t.name;
+            }
+            t.last = v;
+        }
+
+        if (armed) {
+            if (post_left == 0) {
+                write_vcd(trigger_name, trigger_row);
+                armed = false;
+            } else {
+                --post_left;
+            }
+        }
+    }
+
+    static std::string vcd_id(size_t i) {
+        std::string id;
+        do { id += (char)('!' + i % 94); i /= 94; } while (i);
+        return id;
+    }
+
+    static void vcd_value(FILE* f, uint64_t v, int width, const std::string& id) {
+        if (width == 1) {
+            std::fprintf(f, "%c%s\n", (v & 1) ? '1' : '0', id.c_str());
+            return;
+        }
+        char bits[65];
+        int  n = 0;
+        for (int b = width - 1; b >= 0; --b) bits[n++] = ((v >> b) & 1) ? '1' : '0';
+        bits[n] = 0;
+        std::fprintf(f, "b%s %s\n", bits, id.c_str());
+    }
+
+    void write_vcd(const std::string& reason, unsigned mark_row) {
+        std::string path = prefix + "_" + std::to_string(dump_count++) + ".vcd";
+        FILE* f = std::fopen(path.c_str(), "w");
+        if (!f) {
+            cerr << name() << ": cannot write " << path << endl;
+            return;
+        }
+
+        std::fprintf(f, "$version WindowTrace $end\n");
+        std::fprintf(f, "$comment trigger \"%s\" at %llu ps, %u cycle window $end\n", reason.c_str(),
+                     (unsigned long long)times[mark_row], filled);
+        std::fprintf(f, "$timescale 1 ps $end\n$scope module %s $end\n", basename());
+        std::string trig_id = vcd_id(probes.size());
+        for (size_t i = 0; i < probes.size(); ++i) {
+            std::fprintf(f, "$var wire %d %s %s $end\n", probes[i]->width, vcd_id(i).c_str(),
+                         probes[i]->name.c_str());
+        }
+        std::fprintf(f, "$var wire 1 %s trigger $end\n", trig_id.c_str());
+        std::fprintf(f, "$upscope $end\n$enddefinitions $end\n");
+
+        size_t   n     = probes.size();
+        unsigned first = (head + depth - filled) % depth;
+        for (unsigned k = 0; k < filled; ++k) {
+            unsigned r = (first + k) % depth;
+            std::fprintf(f, "#%llu\n", (unsigned long long)times[r]);
+            if (k == 0) std::fprintf(f, "$dumpvars\n");
+            for (size_t i = 0; i < n; ++i) {
+                uint64_t v = data[r * n + i];
+                if (k == 0 || v != data[((r + depth - 1) % depth) * n + i])
+                    vcd_value(f, v, probes[i]->width, vcd_id(i));
+            }
+            if (k == 0 || r == mark_row || (r + depth - 1) % depth == mark_row)
+                vcd_value(f, r == mark_row, 1, trig_id);
+            if (k == 0) std::fprintf(f, "$end\n");
+        }
+        std::fclose(f);
+        cout << name() << ": trigger \"" << reason << "\", wrote " << path << endl;
+    }
+};
+
+#endif // WINDOW_TRACE_H
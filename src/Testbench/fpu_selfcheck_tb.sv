@@ -0,0 +1,179 @@
+// Self-checking, file-driven testbench for FPU.sv (FPPipelinedProcessor).
+// Runs every test of a list back to back, compares the register file with
+// the expected one after each and reports mismatches and instructions
+// retired per cycle. Open-source simulators only (run_sv_selfcheck.sh):
+//
+//   fpu_farm_nonpipelined --generate scen 200 --length 200
+//   fpu_farm_nonpipelined --sv-tests sv scen/manifest.txt
+//   src/Testbench/run_sv_selfcheck.sh iverilog sv/tests.txt
+//
+// List: one test per line, "PROGRAM EXPECTED MAX_CYCLES", paths relative to
+// the list. PROGRAM is $readmemh text with the initial registers at @0 and
+// the RV32F OP-FP program at @20; the rest of the memory is zero, so the
+// program ends at its first zero word. EXPECTED holds the 32 final
+// registers, x for one not checked. Both are written by the farm's
+// --sv-tests from the SystemC non-pipelined model.
+//
+// A test holds the core in reset for two cycles while the registers and
+// the program are loaded through the backdoor, then runs until fetch has
+// reached the zero word and the pipeline has drained, or for MAX_CYCLES.
+// Only the cycles after reset count towards throughput. Retired means
+// register writes, so the first word, which the IFU issues twice after
+// reset, counts twice.
+//
+// Plusargs: +tests=LIST, +show=N (mismatching registers listed per test,
+// default 4), +verbose (one line per passing test too). The last line is
+// "RESULT: PASS" or "RESULT: FAIL".
+module FPPipelinedProcessor_selfcheck_tb;
+    logic clk;
+    logic reset;
+    logic stall;
+    logic monitor_valid;
+    logic [7:0] monitor_pc;
+
+    FPPipelinedProcessor uut (
+        .clk(clk),
+        .reset(reset),
+        .stall(stall),
+        .monitor_valid(monitor_valid),
+        .monitor_pc(monitor_pc)
+    );
+
+    initial begin
+        clk = 0;
+        forever #5 clk = ~clk;
+    end
+
+    localparam int IMEM_WORDS = 256;
+    localparam int PROG_BASE  = 'h20;   // program words in PROGRAM files
+
+    logic [31:0] prog [0:PROG_BASE + IMEM_WORDS - 1];
+    logic [31:0] expected [0:31];
+
+    // Register writes while a test runs; sampled before the edge commits them
+    integer retired;
+    bit     running;
+
+    always @(posedge clk) begin
+        if (running && uut.wb_valid_out && uut.wb_reg_write_en) retired = retired + 1;
+    end
+
+    integer show;
+    bit     verbose;
+
+    function automatic string dirname(string path);
+        for (int i = path.len() - 1; i >= 0; i = i - 1)
+            if (path.getc(i) == "/") return path.substr(0, i);
+        return ".";
+    endfunction
+
+    // Runs one test; mismatches is -1 if a file could not be read
+    task automatic run_test(input string name, input string prog_path, input string exp_path, input integer max_cycles,
+                            output integer mismatches, output integer cycles, output integer insns, output bit timeout);
+        integer fd;
+        bit     drained;
+        begin
+            mismatches = 0;
+            cycles     = 0;
+            insns      = 0;
+            timeout    = 0;
+            fd = $fopen(prog_path, "r");
+            if (fd) $fclose(fd);
+            if (fd) fd = $fopen(exp_path, "r");
+            if (fd == 0) begin
+                $display("%0s: cannot open %0s or %0s", name, prog_path, exp_path);
+                mismatches = -1;
+                return;
+            end
+            $fclose(fd);
+            for (int i = 0; i < PROG_BASE + IMEM_WORDS; i = i + 1) prog[i] = 32'b0;
+            for (int i = 0; i < 32; i = i + 1) expected[i] = 32'bx;
+            $readmemh(prog_path, prog);
+            $readmemh(exp_path, expected);
+
+            // Backdoor load while the core is held in reset, when FPU.sv's
+            // reg_file_update_ff leaves the registers alone. Nonblocking like
+            // that block's own writes (see fpu_selfcheck.vlt).
+            @(negedge clk);
+            reset = 1;
+            for (int i = 0; i < 32; i = i + 1) uut.reg_file[i] <= prog[i];
+            for (int i = 0; i < IMEM_WORDS; i = i + 1) uut.imem.imem[i] = prog[PROG_BASE + i];
+            @(negedge clk);
+            @(negedge clk);
+            reset   = 0;
+            retired = 0;
+            running = 1;
+
+            do begin
+                @(negedge clk);
+                cycles  = cycles + 1;
+                drained = uut.terminated && !uut.ifu_valid_out && !uut.decode_valid_out && !uut.ex_valid_out;
+            end while (!drained && cycles < max_cycles);
+            running = 0;
+            insns   = retired;
+            timeout = !drained;
+
+            for (int r = 0; r < 32; r = r + 1) begin
+                if (!$isunknown(expected[r]) && uut.reg_file[r] !== expected[r]) begin
+                    if (mismatches < show)
+                        $display("%0s: f%0d = %h, expected %h", name, r, uut.reg_file[r], expected[r]);
+                    mismatches = mismatches + 1;
+                end
+            end
+        end
+    endtask
+
+    initial begin
+        string  list, dir, prog_name, exp_name;
+        integer fd, max_cycles, mismatches, cycles, insns;
+        integer tests, failed, total_mismatches, total_cycles, total_retired;
+        bit     timeout;
+
+        reset   = 1;
+        stall   = 0;
+        running = 0;
+        if (!$value$plusargs("tests=%s", list)) begin
+            $display("usage: +tests=LIST [+show=N] [+verbose]");
+            $finish;
+        end
+        if (!$value$plusargs("show=%d", show)) show = 4;
+        verbose = $test$plusargs("verbose");
+        dir = dirname(list);
+        fd  = $fopen(list, "r");
+        if (fd == 0) begin
+            $display("cannot open %0s", list);
+            $display("RESULT: FAIL");
+            $finish;
+        end
+
+        tests            = 0;
+        failed           = 0;
+        total_mismatches = 0;
+        total_cycles     = 0;
+        total_retired    = 0;
+        while ($fscanf(fd, "%s %s %d", prog_name, exp_name, max_cycles) == 3) begin
+            run_test(prog_name, {dir, "/", prog_name}, {dir, "/", exp_name}, max_cycles, mismatches, cycles, insns,
+                     timeout);
+            tests = tests + 1;
+            if (mismatches != 0 || timeout) begin
+                failed = failed + 1;
+                if (timeout) $display("%0s: not drained after %0d cycles", prog_name, max_cycles);
+            end
+            if (mismatches > 0) total_mismatches = total_mismatches + mismatches;
+            total_cycles  = total_cycles + cycles;
+            total_retired = total_retired + insns;
+            if (verbose || mismatches != 0 || timeout)
+                $display("%0s %0s  mismatches %0d  retired %0d  cycles %0d", prog_name,
+                         (mismatches == 0 && !timeout) ? "pass" : "FAIL", mismatches, insns, cycles);
+        end
+        $fclose(fd);
+
+        $display("\n==== Self-check Summary ====");
+        $display("Tests: %0d  Passed: %0d  Failed: %0d  Mismatching registers: %0d",
+                 tests, tests - failed, failed, total_mismatches);
+        $display("Retired: %0d  Cycles: %0d  Retired per cycle: %0.3f", total_retired, total_cycles,
+                 total_cycles ? $itor(total_retired) / $itor(total_cycles) : 0.0);
+        $display("RESULT: %0s", (tests != 0 && failed == 0) ? "PASS" : "FAIL");
+        $finish;
+    end
+endmodule
@@ -0,0 +1,39 @@
+#!/bin/sh
+# Builds fpu_selfcheck_tb.sv against FPU.sv with an open-source simulator
+# and runs a test list through it:
+#   run_sv_selfcheck.sh iverilog|verilator LIST [plusargs...]
+# e.g. run_sv_selfcheck.sh verilator sv/tests.txt +verbose. Exits non-zero
+# unless every test passed; the log is left in selfcheck.log.
+set -e
+
+[ $# -ge 2 ] || { echo "usage: $0 iverilog|verilator LIST [plusargs...]" >&2; exit 2; }
+ROOT=$(cd "$(dirname "$0")/../.." && pwd)
+SIM=$1
+LIST=$2
+shift 2
+TOP=FPPipelinedProcessor_selfcheck_tb
+RTL="$ROOT/src/System Verilog/FPU.sv"
+TB="$ROOT/src/Testbench/fpu_selfcheck_tb.sv"
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+case $SIM in
+iverilog)
+    iverilog -g2012 -s $TOP -o "$WORK/selfcheck" "$RTL" "$TB"
+    RUN="vvp -n $WORK/selfcheck"
+    ;;
+verilator)
+    # Warnings stay fatal; the testbench's own waivers are in fpu_selfcheck.vlt
+    verilator --binary --timing -j 0 --top-module $TOP --Mdir "$WORK/obj" \
+        "$ROOT/src/Verilator/fpu.vlt" "$ROOT/src/Testbench/fpu_selfcheck.vlt" "$RTL" "$TB" \
+        > "$WORK/build.log" 2>&1 || { cat "$WORK/build.log" >&2; exit 1; }
+    RUN="$WORK/obj/V$TOP"
+    ;;
+*)
+    echo "unknown simulator $SIM" >&2
+    exit 2
+    ;;
+esac
+
+$RUN +tests="$LIST" "$@" | tee selfcheck.log
+grep -q "^RESULT: PASS" selfcheck.log
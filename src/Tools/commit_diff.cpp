@@ -0,0 +1,181 @@
+// Streaming comparator for Spike-format commit logs (src/Common/commit_log.h),
+// e.g. a model's --commit-log output against `spike --log-commits`. Both
+// files are read one line at a time, so logs of any size run in constant
+// memory; the first divergence is printed with a few preceding commits.
+//
+//   commit_diff [options] A.log B.log
+//     --fp-only        compare only commits that write an f register
+//                      (drops Spike's integer setup and flw loads, etc.)
+//     --ignore-pc      do not compare PCs (different load addresses)
+//     --ignore-insn    do not compare instruction words (custom encodings)
+//     --no-fflags      do not compare c1_fflags writes
+//     --skip-a N, --skip-b N   drop the first N commits of A or B
+//     --prefix         the shorter log being a prefix of the longer one is a match
+//     --context N      matching commits shown before a divergence (default 3)
+//
+// Exit status: 0 match, 1 divergence, 2 usage or I/O error.
+
+#include "src/Common/commit_log.h"
+#include <cinttypes>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <string>
+
+namespace {
+
+struct diff_options {
+    bool     fp_only     = false;
+    bool     ignore_pc   = false;
+    bool     ignore_insn = false;
+    bool     no_fflags   = false;
+    bool     prefix      = false;
+    uint64_t skip[2]     = {0, 0};
+    size_t   context     = 3;
+    const char* path[2]  = {nullptr, nullptr};
+};
+
+class commit_reader {
+public:
+    commit_reader(FILE* f, const diff_options& o) : file(f), opt(o), line(nullptr), cap(0), lineno(0) {
+        std::setvbuf(file, nullptr, _IOFBF, 1 << 20);
+    }
+    ~commit_reader() { std::free(line); }
+
+    // Next commit that passes the filters; false at end of file
+    bool next(commit_record_t& r) {
+        ssize_t n;
+        while ((n = getline(&line, &cap, file)) > 0) {
+            ++lineno;
+            if (!commit_log_parse(line, r)) continue;
+            if (opt.fp_only && !r.writes_fp()) continue;
+            if (n > 0 && line[n - 1] == '\n') line[n - 1] = 0;
+            return true;
+        }
+        return false;
+    }
+
+    const char* text() const { return line; }
+    uint64_t    line_number() const { return lineno; }
+
+private:
+    FILE*               file;
+    const diff_options& opt;
+    char*               line;
+    size_t              cap;
+    uint64_t            lineno;
+};
+
+// Spike NaN-boxes single-precision values when FLEN > 32
+uint64_t fp_value(const char* name, uint64_t v) {
+    if (name[0] == 'f' && name[1] >= '0' && name[1] <= '9' && (v >> 32) == 0xFFFFFFFFu) return v & 0xFFFFFFFFu;
+    return v;
+}
+
+bool compared(const diff_options& opt, const char* name) {
+    return !(opt.no_fflags && std::strcmp(name, "c1_fflags") == 0);
+}
+
+// Empty when equal, otherwise what differs
+std::string compare(const diff_options& opt, const commit_record_t& a, const commit_record_t& b) {
+    char buf[160];
+    if (!opt.ignore_pc && a.pc != b.pc) {
+        std::snprintf(buf, sizeof(buf), "pc: 0x%08" PRIx64 " vs 0x%08" PRIx64, a.pc, b.pc);
+        return buf;
+    }
+    if (!opt.ignore_insn && a.insn != b.insn) {
+        std::snprintf(buf, sizeof(buf), "insn: 0x%08x vs 0x%08x", a.insn, b.insn);
+        return buf;
+    }
+    for (int i = 0; i < a.num_writes; ++i) {
+        if (!compared(opt, a.name[i])) continue;
+        int j = b.find(a.name[i]);
+        if (j < 0) return std::string(a.name[i]) + ": written only in A";
+        uint64_t va = fp_value(a.name[i], a.value[i]), vb = fp_value(b.name[j], b.value[j]);
+        if (va != vb) {
+            std::snprintf(buf, sizeof(buf), "%s: 0x%08" PRIx64 " vs 0x%08" PRIx64, a.name[i], va, vb);
+            return buf;
+        }
+    }
+    for (int j = 0; j < b.num_writes; ++j)
+        if (compared(opt, b.name[j]) && a.find(b.name[j]) < 0) return std::string(b.name[j]) + ": written only in B";
+    return std::string();
+}
+
+void usage(const char* prog) {
+    std::cerr << "usage: " << prog << " [--fp-only] [--ignore-pc] [--ignore-insn] [--no-fflags]\n"
+              << "       [--skip-a N] [--skip-b N] [--prefix] [--context N] A.log B.log\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    diff_options opt;
+    int npaths = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        bool has_val = i + 1 < argc;
+        if (a == "--fp-only") opt.fp_only = true;
+        else if (a == "--ignore-pc") opt.ignore_pc = true;
+        else if (a == "--ignore-insn") opt.ignore_insn = true;
+        else if (a == "--no-fflags") opt.no_fflags = true;
+        else if (a == "--prefix") opt.prefix = true;
+        else if (a == "--skip-a" && has_val) opt.skip[0] = std::strtoull(argv[++i], nullptr, 0);
+        else if (a == "--skip-b" && has_val) opt.skip[1] = std::strtoull(argv[++i], nullptr, 0);
+        else if (a == "--context" && has_val) opt.context = std::strtoul(argv[++i], nullptr, 0);
+        else if (a[0] != '-' && npaths < 2) opt.path[npaths++] = argv[i];
+        else { npaths = -1; break; }
+    }
+    if (npaths != 2) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    FILE* f[2];
+    for (int k = 0; k < 2; ++k) {
+        if (!(f[k] = std::fopen(opt.path[k], "r"))) {
+            std::cerr << "cannot open " << opt.path[k] << "\n";
+            return 2;
+        }
+    }
+    commit_reader in[2] = {commit_reader(f[0], opt), commit_reader(f[1], opt)};
+    commit_record_t rec[2];
+    for (int k = 0; k < 2; ++k)
+        for (uint64_t s = 0; s < opt.skip[k] && in[k].next(rec[k]); ++s) {}
+
+    std::deque<std::string> recent;   // last matching commits, for context
+    uint64_t n = 0;
+    int status = 0;
+    while (true) {
+        bool more[2] = {in[0].next(rec[0]), in[1].next(rec[1])};
+        if (!more[0] || !more[1]) {
+            if (more[0] != more[1]) {
+                int longer = more[0] ? 0 : 1;
+                std::cout << (longer ? "A" : "B") << " ends after " << n << " commits, "
+                          << (longer ? "B" : "A") << " continues at line " << in[longer].line_number() << ":\n  "
+                          << in[longer].text() << "\n";
+                if (!opt.prefix) status = 1;
+            }
+            break;
+        }
+        std::string what = compare(opt, rec[0], rec[1]);
+        if (!what.empty()) {
+            std::cout << "first divergence at commit " << n << " (A line " << in[0].line_number() << ", B line "
+                      << in[1].line_number() << "): " << what << "\n";
+            for (const std::string& s : recent) std::cout << "     " << s << "\n";
+            std::cout << "  A: " << in[0].text() << "\n  B: " << in[1].text() << "\n";
+            status = 1;
+            break;
+        }
+        if (opt.context) {
+            recent.push_back(in[0].text());
+            if (recent.size() > opt.context) recent.pop_front();
+        }
+        ++n;
+    }
+    if (status == 0) std::cout << n << " commits match\n";
+
+    std::fclose(f[0]);
+    std::fclose(f[1]);
+    return status;
+}
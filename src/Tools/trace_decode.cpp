@@ -0,0 +1,208 @@
+// Decoder for the binary instruction lifecycle traces written by InstTrace.h.
+// Rebuilds every instruction's fetch -> writeback history from the event
+// stream and prints per-segment latency histograms in clock cycles.
+//
+//   trace_decode [--csv] trace.bin
+
+#include "InstTrace.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct inst_t {
+    uint64_t time[TRACE_EVENT_NUM];
+    uint8_t  opcode;
+};
+
+typedef inst_trace_matcher<inst_t>::entry entry_t;
+
+enum segment_id {
+    SEG_FETCH_DECODE = 0,
+    SEG_DECODE_EXECUTE,
+    SEG_EXECUTE_WRITEBACK,  // non-divide ops
+    SEG_EXECUTE_DIV_ENQUEUE,
+    SEG_DIV_ENQUEUE_DONE,
+    SEG_DIV_DONE_WRITEBACK,
+    SEG_TOTAL,              // fetch -> writeback
+    SEG_NUM
+};
+
+const char* const segment_names[SEG_NUM] = {
+    "fetch->decode", "decode->execute", "execute->writeback", "execute->div_enqueue",
+    "div_enqueue->div_done", "div_done->writeback", "fetch->writeback"
+};
+
+const char* const opcode_names[4] = {"fadd", "fsub", "fmul", "fdiv"};
+
+typedef std::map<uint64_t, uint64_t> histogram_t;
+
+struct decoder_t {
+    uint64_t clock_period;
+    inst_trace_matcher<inst_t> matcher;
+    histogram_t seg[SEG_NUM];
+    histogram_t total_by_op[5];   // fadd, fsub, fmul, fdiv, other
+    uint64_t records     = 0;
+    uint64_t completed   = 0;
+    uint64_t div_dropped = 0;
+    uint64_t orphans     = 0;     // event with no matching fetch
+    uint64_t stalls      = 0;
+
+    bool has(const entry_t& i, int ev) const { return i.seen & (1u << ev); }
+
+    void add(int s, const entry_t& i, int from, int to) {
+        if (has(i, from) && has(i, to))
+            ++seg[s][(i.info.time[to] - i.info.time[from]) / clock_period];
+    }
+
+    void retire(const entry_t& i) {
+        ++completed;
+        add(SEG_FETCH_DECODE, i, TRACE_FETCH, TRACE_DECODE);
+        add(SEG_DECODE_EXECUTE, i, TRACE_DECODE, TRACE_EXECUTE);
+        if (has(i, TRACE_DIV_ENQUEUE)) {
+            add(SEG_EXECUTE_DIV_ENQUEUE, i, TRACE_EXECUTE, TRACE_DIV_ENQUEUE);
+            add(SEG_DIV_ENQUEUE_DONE, i, TRACE_DIV_ENQUEUE, TRACE_DIV_DONE);
+            add(SEG_DIV_DONE_WRITEBACK, i, TRACE_DIV_DONE, TRACE_WRITEBACK);
+        } else {
+            add(SEG_EXECUTE_WRITEBACK, i, TRACE_EXECUTE, TRACE_WRITEBACK);
+        }
+        add(SEG_TOTAL, i, TRACE_FETCH, TRACE_WRITEBACK);
+        if (has(i, TRACE_FETCH)) {
+            unsigned op = i.info.opcode < 4 ? i.info.opcode : 4;
+            ++total_by_op[op][(i.info.time[TRACE_WRITEBACK] - i.info.time[TRACE_FETCH]) / clock_period];
+        }
+    }
+
+    void feed(const inst_trace_record_t& r) {
+        ++records;
+        if (r.event >= TRACE_EVENT_NUM) return;
+        if (r.event == TRACE_STALL) {
+            ++stalls;
+            return;
+        }
+        if (r.event == TRACE_FETCH) {
+            matcher.fetch(r.pc).info.time[TRACE_FETCH] = r.time;
+            return;
+        }
+
+        entry_t* e = matcher.match(r.pc, r.event);
+        if (!e) {
+            ++orphans;
+            return;
+        }
+        e->info.time[r.event] = r.time;
+        if (r.event == TRACE_DECODE) e->info.opcode = r.aux;
+
+        if (r.event == TRACE_WRITEBACK) {
+            retire(*e);
+        } else if (r.event == TRACE_DIV_DROP) {
+            ++div_dropped;
+        } else {
+            return;
+        }
+        matcher.retire(r.pc, e);
+    }
+};
+
+uint64_t percentile(const histogram_t& h, uint64_t count, double p) {
+    uint64_t want = (uint64_t)(p * (count - 1)), seen = 0;
+    for (const auto& kv : h) {
+        seen += kv.second;
+        if (seen > want) return kv.first;
+    }
+    return h.empty() ? 0 : h.rbegin()->first;
+}
+
+void print_histogram(std::ostream& os, const char* name, const histogram_t& h) {
+    uint64_t count = 0, sum = 0, peak = 0;
+    for (const auto& kv : h) {
+        count += kv.second;
+        sum += kv.first * kv.second;
+        peak = std::max(peak, kv.second);
+    }
+    if (!count) return;
+
+    os << "\n" << name << ": n=" << count
+       << " min=" << h.begin()->first
+       << " mean=" << std::fixed << std::setprecision(2) << (double)sum / count
+       << " p50=" << percentile(h, count, 0.50)
+       << " p99=" << percentile(h, count, 0.99)
+       << " max=" << h.rbegin()->first << "\n";
+    for (const auto& kv : h) {
+        int bar = (int)((kv.second * 50 + peak - 1) / peak);
+        os << std::setw(8) << kv.first << " | " << std::setw(10) << kv.second << " "
+           << std::string(bar, '#') << "\n";
+    }
+}
+
+void print_csv(std::ostream& os, const char* name, const histogram_t& h) {
+    for (const auto& kv : h) os << name << "," << kv.first << "," << kv.second << "\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bool csv = false;
+    const char* path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--csv") csv = true;
+        else if (!path && a[0] != '-') path = argv[i];
+        else { path = nullptr; break; }
+    }
+    if (!path) {
+        std::cerr << "usage: " << argv[0] << " [--csv] TRACE_FILE\n";
+        return 1;
+    }
+
+    FILE* f = std::fopen(path, "rb");
+    if (!f) {
+        std::cerr << "cannot open " << path << "\n";
+        return 1;
+    }
+
+    inst_trace_header_t h;
+    if (std::fread(&h, sizeof(h), 1, f) != 1 || std::memcmp(h.magic, INST_TRACE_MAGIC, sizeof(h.magic)) != 0 ||
+        h.version != INST_TRACE_VERSION || h.record_size != sizeof(inst_trace_record_t) || h.clock_period == 0) {
+        std::cerr << path << ": not a version " << INST_TRACE_VERSION << " instruction trace\n";
+        std::fclose(f);
+        return 1;
+    }
+
+    decoder_t dec;
+    dec.clock_period = h.clock_period;
+    std::vector<inst_trace_record_t> buf(1 << 16);
+    size_t n;
+    while ((n = std::fread(buf.data(), sizeof(inst_trace_record_t), buf.size(), f)) != 0) {
+        for (size_t i = 0; i < n; ++i) dec.feed(buf[i]);
+    }
+    std::fclose(f);
+
+    if (csv) {
+        std::cout << "segment,cycles,count\n";
+        for (int s = 0; s < SEG_NUM; ++s) print_csv(std::cout, segment_names[s], dec.seg[s]);
+        for (int op = 0; op < 5; ++op) {
+            std::string name = std::string("fetch->writeback:") + (op < 4 ? opcode_names[op] : "other");
+            print_csv(std::cout, name.c_str(), dec.total_by_op[op]);
+        }
+        return 0;
+    }
+
+    std::cout << "records          " << dec.records << "\n"
+              << "retired          " << dec.completed << "\n"
+              << "div_dropped      " << dec.div_dropped << "\n"
+              << "stall_cycles     " << dec.stalls << "\n"
+              << "still_in_flight  " << dec.matcher.in_flight() << "\n"
+              << "orphan_events    " << dec.orphans << "\n";
+    for (int s = 0; s < SEG_NUM; ++s) print_histogram(std::cout, segment_names[s], dec.seg[s]);
+    for (int op = 0; op < 5; ++op) {
+        std::string name = std::string("fetch->writeback [") + (op < 4 ? opcode_names[op] : "other") + "]";
+        print_histogram(std::cout, name.c_str(), dec.total_by_op[op]);
+    }
+    return 0;
+}
@@ -0,0 +1,75 @@
+// Verilator harness for the generated src/System Verilog/FPU.sv
+// (FPPipelinedProcessor, the non-pipelined core). It is a farm model (see
+// src/Farm/farm.h): it reads the same manifests and RV32F images as
+// fpu_farm_nonpipelined, checks expect= entries, and with --reference
+// compares every register write against the stream the SystemC model wrote.
+//
+//   fpu_farm_nonpipelined --generate scen 200
+//   fpu_farm_nonpipelined --retire-log scen scen/manifest.txt
+//   fpu_verilator --reference scen scen/manifest.txt
+
+#include "VFPPipelinedProcessor.h"
+#include "VFPPipelinedProcessor___024root.h"
+#include "verilated.h"
+#include "farm.h"
+
+static const char* const verilator_counter_names[] = {"writebacks_nan_or_inf"};
+
+static const unsigned IMEM_WORDS = 256;
+
+static void run_verilated(const farm_scenario_t& s, const fpu_image_view& img, farm_result_t& r) {
+    VerilatedContext ctx;
+    VFPPipelinedProcessor top(&ctx, "system");
+    VFPPipelinedProcessor___024root& rtl = *top.rootp;
+
+    // Backdoor load, like the SystemC farm filling imem and the reg_file signals
+    for (unsigned i = 0; i < IMEM_WORDS; ++i)
+        rtl.FPPipelinedProcessor__DOT__imem__DOT__imem[i] = i < img.header->num_words ? img.words[i] : 0;
+    for (int i = 0; i < 32; ++i) rtl.FPPipelinedProcessor__DOT__reg_file[i] = img.header->regs[i];
+
+    top.clk   = 0;
+    top.stall = 0;
+    top.reset = 1;
+    top.eval();
+
+    // Two reset edges, matching the SystemC farm's 15 ns reset with a 10 ns clock
+    auto tick = [&]() {
+        top.clk = 1;
+        top.eval();
+        top.clk = 0;
+        top.eval();
+    };
+    tick();
+    tick();
+    top.reset = 0;
+
+    // Writeback is combinational behind Execute's registers, so sampling
+    // after the rising edge sees what the SystemC monitor sees on the falling one
+    for (uint64_t c = 0; c < s.cycles; ++c) {
+        tick();
+        ++r.cycles;
+        if (rtl.FPPipelinedProcessor__DOT__wb_valid_out && rtl.FPPipelinedProcessor__DOT__wb_reg_write_en) {
+            ++r.retired;
+            farm_retire(rtl.FPPipelinedProcessor__DOT__wb_rd_out, rtl.FPPipelinedProcessor__DOT__wb_result_out);
+        }
+    }
+    top.final();
+
+    uint32_t regs[32];
+    for (int i = 0; i < 32; ++i) {
+        regs[i] = rtl.FPPipelinedProcessor__DOT__reg_file[i];
+        if (((regs[i] >> 23) & 0xFF) == 0xFF) ++r.counters[0];
+    }
+    farm_check_expects(s, regs, r);
+}
+
+int main(int argc, char* argv[]) {
+    farm_model_t model;
+    model.name          = "verilator-rtl";
+    model.num_counters  = 1;
+    model.counter_names = verilator_counter_names;
+    model.run           = run_verilated;
+    model.encode        = encode_rv32f;
+    model.max_words     = IMEM_WORDS;
+    return farm_main(argc, argv, model);
+}